@@ -7,21 +7,113 @@ using namespace std;
 using namespace jt;
 using namespace jt::math;
 
+namespace {
+/// Return the number that @c text consists of, or nothing if it contains
+/// anything else.
+optional<u64> parseNumber(string_view text) {
+  u64 number{};
+  const auto *const end    = text.data() + text.size();
+  const auto [last, error] = from_chars(text.data(), end, number);
+  if (error != errc{} || last != end) {
+    return nullopt;
+  }
+  return number;
+}
+
+/// Return the table that is stored in @c cacheFile. A missing or unreadable
+/// cache is replaced by an empty table, that is sieved from scratch.
+PrimeTable loadCache(const filesystem::path &cacheFile) {
+  if (!filesystem::exists(cacheFile)) {
+    return PrimeTable{};
+  }
+  try {
+    return PrimeTable::load(cacheFile);
+  } catch (const runtime_error &e) {
+    cerr << "Ignoring the cache: " << e.what() << "\n";
+    return PrimeTable{};
+  }
+}
+} // namespace
+
 int main(int argc, char **argv) {
-  if (argc != 2) {
-    CONTRACT_ASSERT(argc >= 1);
-    cerr << "Usage: " << argv[0] << " <n>\n\n"
-         << "Finds the first <n> prime numbers using the sieve of "
-            "eratosthenes. Each prime is printed on its own line\n";
+  const auto args = span{argv, static_cast<usize>(argc)};
+  CONTRACT_ASSERT(!args.empty());
+
+  optional<u64> maximumNumber;
+  optional<filesystem::path> cacheFile;
+  usize threads = 1U;
+  for (usize i = 1U; i < args.size(); ++i) {
+    const auto arg = string_view{args[i]};
+    if (arg == "--threads" && i + 1U < args.size()) {
+      const auto count = parseNumber(args[++i]);
+      if (!count) {
+        maximumNumber.reset();
+        break;
+      }
+      threads = max(usize{1U}, usize{*count});
+    } else if (arg == "--cache" && i + 1U < args.size()) {
+      cacheFile = args[++i];
+    } else if (!maximumNumber) {
+      const auto number = parseNumber(arg);
+      if (!number) {
+        break;
+      }
+      maximumNumber = *number;
+    } else {
+      maximumNumber.reset();
+      break;
+    }
+  }
+
+  if (!maximumNumber) {
+    cerr << "Usage: " << args[0]
+         << " <n> [--threads <t>] [--cache <file>]\n\n"
+         << "Finds all prime numbers below <n> using the sieve of "
+            "eratosthenes. Each prime is printed on its own line.\n"
+            "With '--threads' the sieve is distributed over <t> threads.\n"
+            "With '--cache' the primes are read from <file> and only the "
+            "missing primes are sieved and stored in <file> afterwards.\n";
     return EXIT_FAILURE;
   }
 
-  CONTRACT_ASSERT(argc >= 2);
-  usize maximumNumber{stoull(argv[1])};
+  cout << "Finding all primes up to " << *maximumNumber << endl;
+
+  if (cacheFile) {
+    auto table = loadCache(*cacheFile);
+    if (table.limit() < *maximumNumber) {
+      table.extend(*maximumNumber, threads);
+      try {
+        table.save(*cacheFile);
+      } catch (const runtime_error &e) {
+        cerr << "The cache is not updated: " << e.what() << "\n";
+      }
+    }
+    for (const auto prime : table) {
+      if (prime >= *maximumNumber) {
+        break;
+      }
+      cout << prime << "\n";
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // A single thread streams the primes while they are sieved.
+  if (threads == 1U) {
+    for (const auto prime : primes(0U, *maximumNumber)) {
+      cout << prime << "\n";
+    }
+    return EXIT_SUCCESS;
+  }
 
-  cout << "Finding all primes up to " << maximumNumber << endl;
-  for (const auto &prime : sieveEratosthenes<BigUInt>(maximumNumber)) {
-    cout << prime << "\n";
+  // Multiple threads sieve in blocks that keep every thread busy, but bound
+  // the memory for the primes that are waiting to be printed.
+  const u64 blockLength = u64{threads} << 26U;
+  for (u64 low = 0U; low < *maximumNumber;) {
+    const u64 high = low + min(blockLength, *maximumNumber - low);
+    for (const auto prime : sieveRange<u64>(low, high, threads)) {
+      cout << prime << "\n";
+    }
+    low = high;
   }
 
   return EXIT_SUCCESS;
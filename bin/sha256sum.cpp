@@ -12,18 +12,6 @@ struct HashResult {
   filesystem::path path_arg;
 };
 
-HashResult computeHashForFile(filesystem::path arg) {
-  if (!is_regular_file(arg)) {
-    return {"", move(arg)};
-  }
-
-  using namespace jt::crypto;
-  auto hasher = Sha256Sum{};
-  ifstream file(arg, ios::binary);
-  hasher.process(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
-  return {hasher.digest(), move(arg)};
-}
-
 vector<filesystem::path> filesFromArgv(span<char const *> args)
     PRE(args.size() >= 2 && "At least one file argument required") {
   auto files = vector<filesystem::path>{};
@@ -34,14 +22,168 @@ vector<filesystem::path> filesFromArgv(span<char const *> args)
   return files;
 }
 
+/// Files up to this size are mapped and hashed together, many of them in
+/// parallel in the lanes of the vector registers.
+constexpr auto smallFileSize    = uintmax_t{64U * 1024U};
+/// Number of small files, that are mapped at once.
+constexpr size_t smallFileBatch = 256U;
+
+/// Empty files are excluded, because files in @c /proc report a size of
+/// zero and must be read instead.
+bool isSmallFile(filesystem::path const &arg) {
+  auto error      = error_code{};
+  auto const size = is_regular_file(arg, error) ? file_size(arg, error) : 0U;
+  return !error && size > 0U && size <= smallFileSize;
+}
+
+/// Size of the buffers, that the readers fill for the hashers.
+constexpr size_t pipelineBufferSize = size_t{1} << 20U;
+/// Number of filled buffers, that can wait for each hasher.
+constexpr size_t pipelineDepth      = 4U;
+
+/// Part of a file, that a reader passes to its hasher.
+/// The last chunk of a file is empty or marks a read error.
+struct Chunk {
+  size_t file{0};
+  span<byte> buffer;
+  size_t size{0};
+  bool last{false};
+  bool failed{false};
+};
+
+void readFiles(vector<filesystem::path> const &files,
+               span<size_t const> indices, atomic<size_t> &next,
+               jt::BufferPool &pool, jt::BoundedQueue<Chunk> &queue) {
+  for (size_t i = next++; i < indices.size(); i = next++) {
+    auto const file = indices[i];
+    auto input      = optional<jt::FileReader>{};
+    try {
+      input.emplace(files[file]);
+    } catch (system_error const &) {
+      queue.push({.file = file, .buffer = {}, .last = true, .failed = true});
+      continue;
+    }
+    for (bool last = false; !last;) {
+      auto chunk = Chunk{.file = file, .buffer = pool.acquire()};
+      try {
+        chunk.size = input->read(chunk.buffer);
+      } catch (system_error const &) {
+        chunk.failed = true;
+      }
+      chunk.last = last = chunk.size == 0 || chunk.failed;
+      queue.push(chunk);
+    }
+  }
+  queue.close();
+}
+
+void hashChunks(vector<filesystem::path> const &files, jt::BufferPool &pool,
+                jt::BoundedQueue<Chunk> &queue, vector<HashResult> &result) {
+  auto hasher = jt::crypto::Sha256Sum{};
+  while (auto chunk = queue.pop()) {
+    if (!chunk->failed) {
+      hasher.process(span{chunk->buffer}.first(chunk->size));
+    }
+    if (!chunk->buffer.empty()) {
+      pool.release(chunk->buffer);
+    }
+    if (chunk->last) {
+      result[chunk->file] = {chunk->failed ? "" : hasher.digest(),
+                             files[chunk->file]};
+      hasher.reset();
+    }
+  }
+}
+
+/// Hash the files at @c indices in a pipeline. Each lane has a reader
+/// thread, that fills buffers of a shared pool with one file after another,
+/// and a hasher thread, that consumes them through a bounded queue.
+/// Reading and hashing overlap, and the memory is bounded by the pool
+/// independent of the file sizes. The hash of one file is a sequential
+/// chain, so a single huge file still occupies only one hasher.
+void hashPipelined(vector<filesystem::path> const &files,
+                   span<size_t const> indices, vector<HashResult> &result) {
+  auto const lanes = min(jt::hardwareThreads(), indices.size());
+  if (lanes == 0) {
+    return;
+  }
+  auto pool   = jt::BufferPool{lanes * (pipelineDepth + 1), pipelineBufferSize};
+  auto queues = deque<jt::BoundedQueue<Chunk>>{};
+  auto next   = atomic<size_t>{0};
+
+  auto threads = vector<jthread>{};
+  threads.reserve(2 * lanes);
+  for (size_t lane = 0; lane < lanes; ++lane) {
+    auto *const queue = &queues.emplace_back(pipelineDepth);
+    threads.emplace_back(
+        [&, queue] { readFiles(files, indices, next, pool, *queue); });
+    threads.emplace_back(
+        [&, queue] { hashChunks(files, pool, *queue, result); });
+  }
+}
+
 vector<HashResult> computeHashes(vector<filesystem::path> const &files) {
   auto result = vector<HashResult>{files.size()};
-  transform(execution::par, files.begin(), files.end(), result.begin(),
-            computeHashForFile);
+  auto small  = vector<size_t>{};
+  auto large  = vector<size_t>{};
+  for (size_t i = 0; i < files.size(); ++i) {
+    (isSmallFile(files[i]) ? small : large).push_back(i);
+  }
+
+  hashPipelined(files, large, result);
+
+  auto batches =
+      vector<size_t>((small.size() + smallFileBatch - 1) / smallFileBatch);
+  iota(batches.begin(), batches.end(), size_t{0});
+  for_each(execution::par, batches.begin(), batches.end(), [&](size_t b) {
+    auto const first = b * smallFileBatch;
+    auto const batch =
+        span{small}.subspan(first, min(smallFileBatch, small.size() - first));
+    auto mapped = vector<jt::MappedFile>{};
+    auto views  = vector<string_view>(batch.size());
+    auto failed = vector<bool>(batch.size());
+    mapped.reserve(batch.size());
+    for (size_t k = 0; k < batch.size(); ++k) {
+      try {
+        auto const bytes =
+            mapped.emplace_back(files[batch[k]], jt::FileAccess::Sequential)
+                .bytes();
+        views[k] = {reinterpret_cast<char const *>(bytes.data()), bytes.size()};
+      } catch (system_error const &) {
+        failed[k] = true;
+      }
+    }
+    auto const digests = jt::crypto::sha256Batch(views);
+    for (size_t k = 0; k < batch.size(); ++k) {
+      result[batch[k]] = {failed[k] ? "" : digests[k], files[batch[k]]};
+    }
+  });
 
   return result;
 }
 
+/// Hash the files one after another with the tree hash, that distributes
+/// the chunks of each file on all threads.
+vector<HashResult> computeTreeHashes(vector<filesystem::path> const &files) {
+  auto result = vector<HashResult>{};
+  result.reserve(files.size());
+  for (auto const &file : files) {
+    try {
+      auto reader = jt::FileReader{file};
+      auto tree   = jt::crypto::Sha256Tree{};
+      for (auto chunk = reader.next(); !chunk.empty(); chunk = reader.next()) {
+        tree.process(chunk);
+      }
+      result.emplace_back(tree.digest(), file);
+    } catch (system_error const &) {
+      result.emplace_back("", file);
+    }
+  }
+  return result;
+}
+
+using HashFunction = vector<HashResult>(vector<filesystem::path> const &);
+
 void hashPrinter(HashResult const &r) {
   if (r.digest.empty()) {
     cerr << "File: '" << r.path_arg.string() << "' could not be hashed!\n";
@@ -74,15 +216,17 @@ vector<HashResult> readHashes(filesystem::path const &inFile) {
 }
 
 using HashComparison = pair<HashResult, HashResult const *>;
-HashComparison verifyHash(HashResult const &expectedResult) {
-  auto const actual = computeHashForFile(expectedResult.path_arg);
-  return make_pair(actual, &expectedResult);
-}
 
-bool filesMatchExpectedHashes(vector<HashResult> const &expectedHashes) {
-  auto comparison = vector<HashComparison>(expectedHashes.size());
-  transform(execution::par, expectedHashes.begin(), expectedHashes.end(),
-            comparison.begin(), verifyHash);
+bool filesMatchExpectedHashes(vector<HashResult> const &expectedHashes,
+                              HashFunction *hashFiles) {
+  auto paths = vector<filesystem::path>{};
+  ranges::transform(expectedHashes, back_inserter(paths),
+                    &HashResult::path_arg);
+  auto const actual = hashFiles(paths);
+  auto comparison   = vector<HashComparison>{};
+  for (size_t i = 0; i < actual.size(); ++i) {
+    comparison.emplace_back(actual[i], &expectedHashes[i]);
+  }
   return all_of(
       comparison.begin(), comparison.end(), [&](HashComparison const &hc) {
         bool const matches = hc.first.digest == hc.second->digest;
@@ -101,13 +245,22 @@ bool filesMatchExpectedHashes(vector<HashResult> const &expectedHashes) {
 } // namespace
 
 int main(int argc, char const **argv) {
-  auto const args = span{argv, static_cast<size_t>(argc)};
+  // '--tree' selects the tree hash instead of the plain SHA-256 for hashing
+  // and checking.
+  auto options   = vector<char const *>(argv, argv + argc);
+  auto hashFiles = &computeHashes;
+  if (options.size() >= 2 && strcmp(options[1], "--tree") == 0) {
+    options.erase(options.begin() + 1);
+    hashFiles = &computeTreeHashes;
+  }
+
+  auto const args = span{options};
   if (args.size() < 2) {
     cerr << "Error: " << args[0]
          << " - At least one file to hash must be provided!\n";
     return jt::EXIT_FAILURE;
   }
-  CONTRACT_ASSERT(argc >= 2 &&
+  CONTRACT_ASSERT(args.size() >= 2 &&
                   "At least one argument is guaranteed from here on");
   if (strcmp(args[1], "-c") == 0 || strcmp(args[1], "--check") == 0) {
     if (args.size() != 3) {
@@ -116,11 +269,12 @@ int main(int argc, char const **argv) {
       return jt::EXIT_FAILURE;
     }
     auto const expectedHashes = readHashes(args[2]);
-    return filesMatchExpectedHashes(expectedHashes) ? jt::EXIT_SUCCESS
-                                                    : jt::EXIT_FAILURE;
+    return filesMatchExpectedHashes(expectedHashes, hashFiles)
+               ? jt::EXIT_SUCCESS
+               : jt::EXIT_FAILURE;
   }
   auto const files  = filesFromArgv(args);
-  auto const result = computeHashes(files);
+  auto const result = hashFiles(files);
   outputHashes(result);
 
   return jt::EXIT_SUCCESS;
@@ -75,9 +75,7 @@ template <NaturalNumber NumberType> void measureSigning() {
 } // namespace
 
 int main() {
-#if 0
-    measureSigning<BigUInt>();
-#endif
+  measureSigning<BigUInt>();
   measureSigning<NaturalN>();
   return jt::EXIT_SUCCESS;
 }
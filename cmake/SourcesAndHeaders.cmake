@@ -1,14 +1,22 @@
 set(module_sources
     lib/core/Core.cppm
     lib/core/Constants.cpp
+    lib/core/CpuFeatures.cpp
+    lib/core/MappedFile.cpp
+    lib/core/Parallel.cpp
     lib/core/Types.cpp
 
     lib/container/Container.cppm
+    lib/container/AtomicBitVector.cpp
     lib/container/BitVector.cpp
+    lib/container/RankSelect.cpp
+    lib/container/RoaringBitmap.cpp
 
     lib/crypto/Crypto.cppm
     lib/crypto/Concepts.cpp
     lib/crypto/Sha256.cpp
+    lib/crypto/Sha256MultiBuffer.cpp
+    lib/crypto/Sha256Tree.cpp
     lib/crypto/TextbookRSA.cpp
 
     lib/math/Math.cppm
@@ -18,24 +26,38 @@ set(module_sources
     lib/math/Concepts.cpp
     lib/math/FixedSquareMatrix.cpp
     lib/math/GenericPower.cpp
+    lib/math/Limbs.cpp
     lib/math/ModularArithmetic.cpp
     lib/math/NaturalN.cpp
     lib/math/NaturalNImpl.cpp
     lib/math/NaturalNumberAlgorithms.cpp
     lib/math/NumberIO.cpp
+    lib/math/PrimeSieve.cpp
+    lib/math/PrimeTable.cpp
     lib/math/Rational.cpp
     lib/math/Operations.cpp
 )
 
 set(test_sources
+    lib/core/CpuFeatures.cpp
+    lib/core/MappedFile.cpp
+    lib/core/Parallel.cpp
+    lib/container/AtomicBitVector.cpp
     lib/container/BitVector.cpp
+    lib/container/RankSelect.cpp
+    lib/container/RoaringBitmap.cpp
     lib/crypto/Sha256.cpp
+    lib/crypto/Sha256MultiBuffer.cpp
+    lib/crypto/Sha256Tree.cpp
     lib/crypto/TextbookRSA.cpp
     lib/math/BigUInt.cpp
     lib/math/BigInt.cpp
     lib/math/GenericPower.cpp
+    lib/math/Limbs.cpp
     lib/math/ModularArithmetic.cpp
     lib/math/NaturalN.cpp
     lib/math/NaturalNumberAlgorithms.cpp
+    lib/math/PrimeSieve.cpp
+    lib/math/PrimeTable.cpp
     lib/math/Rational.cpp
 )
@@ -0,0 +1,161 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Container:AtomicBitVector;
+
+import :BitVector;
+
+import std;
+import jt.Core;
+
+using namespace std;
+
+namespace jt::container {
+
+/// Fixed size sequence of bits, that many threads can set concurrently.
+///
+/// The bits are packed into atomic 64-bit words like in @c BitVector. Bits
+/// can only be set, never cleared, so all operations use relaxed memory
+/// order: a set bit stays set no matter in which order the threads run.
+/// Other memory is not synchronized by setting a bit. Join the threads, e.g.
+/// by returning from @c parallelFor, before relying on the final state.
+/// @sa BitVector
+export class AtomicBitVector {
+public:
+  using Word                         = BitVector::Word;
+  static constexpr usize BitsPerWord = BitVector::BitsPerWord;
+
+  AtomicBitVector() = default;
+
+  /// Construct @c size cleared bits.
+  explicit AtomicBitVector(usize size);
+
+  /// Construct a copy of the bits of @c bits.
+  explicit AtomicBitVector(const BitVector &bits);
+
+  [[nodiscard]] usize size() const noexcept { return _size; }
+  [[nodiscard]] usize wordCount() const noexcept {
+    return (_size + BitsPerWord - 1U) / BitsPerWord;
+  }
+
+  /// Return the bit at @c index.
+  [[nodiscard]] bool get(usize index) const PRE(index < size()) {
+    return (_words[index / BitsPerWord].load(memory_order_relaxed) &
+            _mask(index)) != 0U;
+  }
+
+  /// Set the bit at @c index.
+  void set(usize index) PRE(index < size()) {
+    _words[index / BitsPerWord].fetch_or(_mask(index), memory_order_relaxed);
+  }
+
+  /// Set the bit at @c index and return its previous value.
+  /// Of all threads that set the same bit concurrently, exactly one sees
+  /// @c false, which makes this suitable for claiming a work item, like a
+  /// node in a graph traversal.
+  bool testAndSet(usize index) PRE(index < size()) {
+    const Word mask = _mask(index);
+    return (_words[index / BitsPerWord].fetch_or(mask, memory_order_relaxed) &
+            mask) != 0U;
+  }
+
+  /// Set the bits of @c bits in word @c wordIndex and return the previous
+  /// value of the word.
+  /// @pre Bits beyond @c size() are not set.
+  Word fetchOr(usize wordIndex, Word bits) PRE(wordIndex < wordCount());
+
+  /// Set the bits @c first, @c first+stride, ... below @c last.
+  /// All bits within one word are combined into a single atomic operation.
+  /// @pre stride > 0
+  void setStride(usize first, usize last, usize stride)
+      PRE(stride > 0U && last <= size());
+
+  /// Set the bits within @c [first, last) with one atomic operation per word.
+  void setRange(usize first, usize last) PRE(first <= last && last <= size());
+
+  /// Return the number of set bits.
+  [[nodiscard]] usize count() const;
+
+  /// Return a plain copy of the bits.
+  /// Only the words are copied, there is no work per bit.
+  [[nodiscard]] BitVector toBitVector() const;
+
+private:
+  [[nodiscard]] static constexpr Word _mask(usize index) noexcept {
+    return Word{1U} << (index % BitsPerWord);
+  }
+
+  unique_ptr<atomic<Word>[]> _words;
+  usize _size{0U};
+};
+
+AtomicBitVector::AtomicBitVector(usize size)
+    : _words{make_unique<atomic<Word>[]>((size + BitsPerWord - 1U) /
+                                         BitsPerWord)},
+      _size{size} {}
+
+AtomicBitVector::AtomicBitVector(const BitVector &bits)
+    : AtomicBitVector(bits.size()) {
+  const auto words = bits.words();
+  for (usize w = 0U; w < words.size(); ++w) {
+    _words[w].store(words[w], memory_order_relaxed);
+  }
+}
+
+AtomicBitVector::Word AtomicBitVector::fetchOr(usize wordIndex, Word bits) {
+  CONTRACT_ASSERT(wordIndex + 1U < wordCount() || _size % BitsPerWord == 0U ||
+                  (bits >> (_size % BitsPerWord)) == 0U);
+  return _words[wordIndex].fetch_or(bits, memory_order_relaxed);
+}
+
+void AtomicBitVector::setStride(usize first, usize last, usize stride) {
+  usize index = first;
+  while (index < last) {
+    const usize wordIndex = index / BitsPerWord;
+    const usize wordEnd   = min(last, (wordIndex + 1U) * BitsPerWord);
+    Word bits             = 0U;
+    for (; index < wordEnd; index += stride) {
+      bits |= _mask(index);
+    }
+    _words[wordIndex].fetch_or(bits, memory_order_relaxed);
+  }
+}
+
+void AtomicBitVector::setRange(usize first, usize last) {
+  if (first == last) {
+    return;
+  }
+  const usize firstWord = first / BitsPerWord;
+  const usize lastWord  = (last - 1U) / BitsPerWord;
+  for (usize w = firstWord; w <= lastWord; ++w) {
+    Word bits = ~Word{0U};
+    if (w == firstWord) {
+      bits &= ~Word{0U} << (first % BitsPerWord);
+    }
+    if (w == lastWord) {
+      bits &= ~Word{0U} >> (BitsPerWord - 1U - (last - 1U) % BitsPerWord);
+    }
+    _words[w].fetch_or(bits, memory_order_relaxed);
+  }
+}
+
+usize AtomicBitVector::count() const {
+  usize result = 0U;
+  for (usize w = 0U; w < wordCount(); ++w) {
+    const Word word = _words[w].load(memory_order_relaxed);
+    result += static_cast<usize>(popcount(word));
+  }
+  return result;
+}
+
+BitVector AtomicBitVector::toBitVector() const {
+  auto result = BitVector{_size, /*initialValue=*/false};
+  auto words  = result.words();
+  for (usize w = 0U; w < words.size(); ++w) {
+    words[w] = _words[w].load(memory_order_relaxed);
+  }
+  return result;
+}
+
+} // namespace jt::container
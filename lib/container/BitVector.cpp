@@ -11,8 +11,169 @@ using namespace std;
 
 namespace jt::container {
 
+/// Forward iterator over the indices of the set bits of a @c BitVector.
+/// Each word is scanned with @c countr_zero, skipping all cleared bits.
+export class SetBitIterator {
+public:
+  using Word                         = u64;
+  static constexpr usize BitsPerWord = numeric_limits<Word>::digits;
+
+  using iterator_concept  = forward_iterator_tag;
+  using iterator_category = forward_iterator_tag;
+  using value_type        = usize;
+  using difference_type   = pdiff;
+
+  SetBitIterator() = default;
+  explicit SetBitIterator(span<const Word> words) : _words{words} {
+    if (!_words.empty()) {
+      _current = _words[0];
+      _skipEmptyWords();
+    }
+  }
+
+  usize operator*() const noexcept {
+    return _wordIndex * BitsPerWord + static_cast<usize>(countr_zero(_current));
+  }
+
+  SetBitIterator &operator++() noexcept {
+    // Clear the lowest set bit.
+    _current &= _current - 1U;
+    _skipEmptyWords();
+    return *this;
+  }
+  SetBitIterator operator++(int) noexcept {
+    auto before = *this;
+    ++*this;
+    return before;
+  }
+
+  friend bool operator==(const SetBitIterator &a,
+                         const SetBitIterator &b) noexcept {
+    return a._wordIndex == b._wordIndex && a._current == b._current;
+  }
+  friend bool operator==(const SetBitIterator &it,
+                         default_sentinel_t /*end*/) noexcept {
+    return it._wordIndex >= it._words.size();
+  }
+
+private:
+  void _skipEmptyWords() noexcept {
+    while (_current == 0U && ++_wordIndex < _words.size()) {
+      _current = _words[_wordIndex];
+    }
+  }
+
+  span<const Word> _words;
+  usize _wordIndex{0U};
+  Word _current{0U};
+};
+
+/// Contiguous storage for the words of a @c BitVector. Up to @c inlineWords
+/// words are stored within the object itself and only bigger vectors
+/// allocate, so small numbers never touch the allocator.
+class WordStorage {
+public:
+  using Word                         = u64;
+  static constexpr usize inlineWords = 2U;
+
+  WordStorage() = default;
+  WordStorage(usize count, Word value) { resize(count, value); }
+
+  WordStorage(const WordStorage &other) { _copy(other); }
+  WordStorage(WordStorage &&other) noexcept { _steal(other); }
+  WordStorage &operator=(const WordStorage &other) {
+    if (this != &other) {
+      _size = 0U;
+      _copy(other);
+    }
+    return *this;
+  }
+  WordStorage &operator=(WordStorage &&other) noexcept {
+    if (this != &other) {
+      _steal(other);
+    }
+    return *this;
+  }
+  ~WordStorage() = default;
+
+  [[nodiscard]] Word *data() noexcept {
+    return _heap ? _heap.get() : _inline.data();
+  }
+  [[nodiscard]] const Word *data() const noexcept {
+    return _heap ? _heap.get() : _inline.data();
+  }
+  [[nodiscard]] usize size() const noexcept { return _size; }
+  [[nodiscard]] usize capacity() const noexcept { return _capacity; }
+  [[nodiscard]] bool empty() const noexcept { return _size == 0U; }
+
+  [[nodiscard]] Word *begin() noexcept { return data(); }
+  [[nodiscard]] Word *end() noexcept { return data() + _size; }
+  [[nodiscard]] const Word *begin() const noexcept { return data(); }
+  [[nodiscard]] const Word *end() const noexcept { return data() + _size; }
+
+  [[nodiscard]] Word &operator[](usize i) noexcept { return data()[i]; }
+  [[nodiscard]] Word operator[](usize i) const noexcept { return data()[i]; }
+  [[nodiscard]] Word &back() noexcept { return data()[_size - 1U]; }
+  [[nodiscard]] Word back() const noexcept { return data()[_size - 1U]; }
+
+  /// Change the number of words, new words are set to @c value.
+  /// Shrinking keeps the capacity.
+  void resize(usize count, Word value = Word{0U}) {
+    if (count > _capacity) {
+      _reserve(max(count, 2U * _capacity));
+    }
+    if (count > _size) {
+      std::fill(data() + _size, data() + count, value);
+    }
+    _size = count;
+  }
+  void push_back(Word word) { resize(_size + 1U, word); }
+
+private:
+  void _reserve(usize capacity) {
+    auto heap = make_unique_for_overwrite<Word[]>(capacity);
+    copy(begin(), end(), heap.get());
+    _heap     = std::move(heap);
+    _capacity = capacity;
+  }
+  void _copy(const WordStorage &other) {
+    if (other._size > _capacity) {
+      _reserve(other._size);
+    }
+    copy(other.begin(), other.end(), data());
+    _size = other._size;
+  }
+  void _steal(WordStorage &other) noexcept {
+    if (other._heap) {
+      _heap     = std::move(other._heap);
+      _capacity = other._capacity;
+    } else {
+      _heap.reset();
+      _inline   = other._inline;
+      _capacity = inlineWords;
+    }
+    _size           = other._size;
+    other._size     = 0U;
+    other._capacity = inlineWords;
+  }
+
+  unique_ptr<Word[]> _heap;
+  array<Word, inlineWords> _inline{};
+  usize _size{0U};
+  usize _capacity{inlineWords};
+};
+
+/// Sequence of bits, that are packed into 64-bit words.
+/// Bit @c i is stored in word @c i/64 at position @c i%64. Bits in the last
+/// word beyond @c size() are always zero. Vectors of up to 128 bits do not
+/// allocate.
 export class BitVector {
 public:
+  using Word                         = u64;
+  static constexpr usize BitsPerWord = numeric_limits<Word>::digits;
+
+  using SetBitIterator = container::SetBitIterator;
+
   BitVector() = default;
 
   /// Construct a @c BitVector that has enough bits to represent @c value and
@@ -22,21 +183,90 @@ public:
   /// Construct a @c BitVector with initial capacity of at least @c length bits.
   BitVector(usize length, bool initialValue);
 
+  BitVector(const BitVector &)            = default;
+  BitVector &operator=(const BitVector &) = default;
+  /// A moved-from vector is empty.
+  BitVector(BitVector &&other) noexcept
+      : _data{std::move(other._data)}, _size{exchange(other._size, 0U)} {}
+  BitVector &operator=(BitVector &&other) noexcept {
+    _data = std::move(other._data);
+    _size = exchange(other._size, 0U);
+    return *this;
+  }
+  ~BitVector() = default;
+
   /// Return the underlying capacity of bits. This is a multiple of an integer
   /// type bits.
-  [[nodiscard]] usize capacity() const noexcept { return _data.capacity(); }
+  [[nodiscard]] usize capacity() const noexcept {
+    return _data.capacity() * BitsPerWord;
+  }
 
   /// Return the current number of bits managed by the vector.
-  [[nodiscard]] usize size() const noexcept { return _data.size(); }
+  [[nodiscard]] usize size() const noexcept { return _size; }
 
   /// Return the bit at any position.
-  [[nodiscard]] bool get(usize index) const { return _data.at(index) == u8{1}; }
+  [[nodiscard]] bool get(usize index) const PRE(index < size()) {
+    return (_data[index / BitsPerWord] & _mask(index)) != 0U;
+  }
 
   /// Provide access to the bit at any position.
-  void set(usize index, bool value) { _data.at(index) = value ? u8{1} : u8{0}; }
+  void set(usize index, bool value) PRE(index < size()) {
+    auto &word = _data[index / BitsPerWord];
+    word       = value ? (word | _mask(index)) : (word & ~_mask(index));
+  }
 
   /// Append a new bit to the end of the vector.
-  void push_back(bool bit) { _data.push_back(bit ? u8{1} : u8{0}); }
+  void push_back(bool bit) {
+    if (_size % BitsPerWord == 0U) {
+      _data.push_back(Word{0U});
+    }
+    ++_size;
+    set(_size - 1U, bit);
+  }
+
+  /// Change the number of bits to @c newSize. New bits are @c false.
+  /// Shrinking keeps the capacity.
+  void resize(usize newSize);
+
+  /// Assign @c value to all bits within @c [first, last).
+  /// @pre first <= last && last <= size()
+  void fill(usize first, usize last, bool value)
+      PRE(first <= last && last <= size());
+
+  /// Invert all bits.
+  void flip();
+
+  /// Return the number of set bits.
+  [[nodiscard]] usize count() const noexcept;
+
+  /// Return the index of the first set bit, or @c size() if there is none.
+  [[nodiscard]] usize findFirst() const noexcept { return findNext(0U); }
+
+  /// Return the index of the first set bit at or after @c index, or @c size()
+  /// if there is none.
+  [[nodiscard]] usize findNext(usize index) const noexcept;
+
+  /// Return the indices of all set bits in ascending order.
+  /// @code
+  /// for (const usize i : bits.setBits()) { ... }
+  /// @endcode
+  [[nodiscard]] ranges::subrange<SetBitIterator, default_sentinel_t>
+  setBits() const noexcept;
+
+  /// Return the up to @c BitsPerWord bits starting at @c index. Bit @c index
+  /// becomes the lowest bit and bits beyond @c size() are zero.
+  [[nodiscard]] Word wordAt(usize index) const PRE(index < size());
+
+  /// Return the words that store the bits, bit @c i is in word
+  /// @c i/BitsPerWord at position @c i%BitsPerWord.
+  /// @note Bits beyond @c size() in the last word must remain zero.
+  [[nodiscard]] span<const Word> words() const noexcept { return _data; }
+  [[nodiscard]] span<Word> words() noexcept { return _data; }
+
+  /// Combine the bits of two vectors of the same size word by word.
+  BitVector &operator&=(const BitVector &other) PRE(size() == other.size());
+  BitVector &operator|=(const BitVector &other) PRE(size() == other.size());
+  BitVector &operator^=(const BitVector &other) PRE(size() == other.size());
 
   /// Removes leading zeros from the @c BitVector.
   void normalize();
@@ -55,36 +285,219 @@ public:
   BitVector &operator>>=(int i) PRE(i > 0) PRE(usize(i) < this->size());
 
 private:
-  vector<u8> _data;
+  [[nodiscard]] static constexpr Word _mask(usize index) noexcept {
+    return Word{1U} << (index % BitsPerWord);
+  }
+  [[nodiscard]] static constexpr usize _wordCount(usize bits) noexcept {
+    return (bits + BitsPerWord - 1U) / BitsPerWord;
+  }
+
+  /// Clear the bits in the last word beyond @c size().
+  void _clearTail() noexcept {
+    if (_size % BitsPerWord != 0U) {
+      _data.back() &= _mask(_size) - 1U;
+    }
+  }
+
+  /// Apply @c op to each pair of words. The plain loop over both arrays is
+  /// vectorized by the compiler.
+  template <typename Op> void _combine(const BitVector &other, Op op) {
+    Word *dst       = _data.data();
+    const Word *src = other._data.data();
+    const usize n   = _data.size();
+    for (usize i = 0U; i < n; ++i) {
+      dst[i] = op(dst[i], src[i]);
+    }
+  }
+
+  WordStorage _data;
+  usize _size{0U};
 };
 
+/// Bitwise operations on vectors of the same size.
+export BitVector operator&(BitVector a, const BitVector &b) {
+  return a &= b;
+}
+export BitVector operator|(BitVector a, const BitVector &b) {
+  return a |= b;
+}
+export BitVector operator^(BitVector a, const BitVector &b) {
+  return a ^= b;
+}
+export BitVector operator~(BitVector a) {
+  a.flip();
+  return a;
+}
+
 BitVector::BitVector(unsigned_integral auto value)
-    : _data(sizeof(value) * BitsPerByte, u8{0}) {
-  for (u32 i = 0U; i < BitsPerByte * sizeof(value); ++i) {
-    const bool bitFromValue = value & (static_cast<decltype(value)>(1U) << i);
-    set(i, bitFromValue);
+    : _data(_wordCount(sizeof(value) * BitsPerByte), Word{0U}),
+      _size{sizeof(value) * BitsPerByte} {
+  // A value fits into a single word, but wider integer types are handled as
+  // well.
+  for (usize w = 0U; w < _data.size(); ++w) {
+    if constexpr (sizeof(value) * BitsPerByte <= BitsPerWord) {
+      _data[w] = static_cast<Word>(value);
+    } else {
+      _data[w] = static_cast<Word>(value >> (w * BitsPerWord));
+    }
   }
 }
 
 BitVector::BitVector(usize length, bool initialValue)
-    : _data(length, initialValue ? u8{1} : u8{0}) {}
+    : _data(_wordCount(length), initialValue ? ~Word{0U} : Word{0U}),
+      _size{length} {
+  // Keep the bits beyond 'size()' cleared.
+  if (initialValue && length % BitsPerWord != 0U) {
+    _data.back() &= _mask(length) - 1U;
+  }
+}
+
+void BitVector::resize(usize newSize) {
+  _data.resize(_wordCount(newSize), Word{0U});
+  _size = newSize;
+  _clearTail();
+}
+
+void BitVector::fill(usize first, usize last, bool value) {
+  if (first == last) {
+    return;
+  }
+  const usize firstWord = first / BitsPerWord;
+  const usize lastWord  = (last - 1U) / BitsPerWord;
+  // Masks of the bits within [first, last) in the first and the last word.
+  const Word firstMask  = ~(_mask(first) - 1U);
+  const Word lastMask =
+      ~Word{0U} >> (BitsPerWord - 1U - (last - 1U) % BitsPerWord);
+
+  const auto assign = [value](Word &word, Word mask) {
+    word = value ? (word | mask) : (word & ~mask);
+  };
+  if (firstWord == lastWord) {
+    assign(_data[firstWord], firstMask & lastMask);
+    return;
+  }
+  assign(_data[firstWord], firstMask);
+  std::fill(_data.begin() + firstWord + 1U, _data.begin() + lastWord,
+            value ? ~Word{0U} : Word{0U});
+  assign(_data[lastWord], lastMask);
+}
+
+void BitVector::flip() {
+  for (auto &word : _data) {
+    word = ~word;
+  }
+  _clearTail();
+}
+
+usize BitVector::count() const noexcept {
+  usize result = 0U;
+  for (const Word word : _data) {
+    result += static_cast<usize>(popcount(word));
+  }
+  return result;
+}
+
+usize BitVector::findNext(usize index) const noexcept {
+  if (index >= _size) {
+    return _size;
+  }
+  usize wordIndex = index / BitsPerWord;
+  // Ignore the bits before 'index' in its word.
+  Word word       = _data[wordIndex] & ~(_mask(index) - 1U);
+  while (word == 0U) {
+    if (++wordIndex == _data.size()) {
+      return _size;
+    }
+    word = _data[wordIndex];
+  }
+  return wordIndex * BitsPerWord + static_cast<usize>(countr_zero(word));
+}
+
+ranges::subrange<BitVector::SetBitIterator, default_sentinel_t>
+BitVector::setBits() const noexcept {
+  return {SetBitIterator{_data}, default_sentinel};
+}
+
+BitVector::Word BitVector::wordAt(usize index) const {
+  const usize wordIndex = index / BitsPerWord;
+  const usize shift     = index % BitsPerWord;
+  Word result           = _data[wordIndex] >> shift;
+  if (shift != 0U && wordIndex + 1U < _data.size()) {
+    result |= _data[wordIndex + 1U] << (BitsPerWord - shift);
+  }
+  return result;
+}
+
+BitVector &BitVector::operator&=(const BitVector &other) {
+  _combine(other, [](Word a, Word b) { return a & b; });
+  return *this;
+}
+
+BitVector &BitVector::operator|=(const BitVector &other) {
+  _combine(other, [](Word a, Word b) { return a | b; });
+  return *this;
+}
+
+BitVector &BitVector::operator^=(const BitVector &other) {
+  _combine(other, [](Word a, Word b) { return a ^ b; });
+  return *this;
+}
 
 void BitVector::normalize() {
-  const auto itFirstOne = find(_data.crbegin(), _data.crend(), u8{1});
-  _data.erase(_data.begin() + distance(itFirstOne, _data.crend()), _data.end());
+  usize words = _data.size();
+  while (words > 0U && _data[words - 1U] == 0U) {
+    --words;
+  }
+  _data.resize(words);
+  _size = words == 0U ? 0U
+                      : words * BitsPerWord -
+                            static_cast<usize>(countl_zero(_data.back()));
 }
 
 BitVector &BitVector::operator<<=(int i) {
-  const auto sizeBefore [[maybe_unused]] = _data.size();
-  _data.insert(_data.begin(), usize(i), u8{0});
+  const auto sizeBefore  = _size;
+  const usize wordShift  = usize(i) / BitsPerWord;
+  const usize bitShift   = usize(i) % BitsPerWord;
+  const usize wordsAfter = _wordCount(sizeBefore + usize(i));
+  // Growing within the capacity does not reallocate. The new words are zero.
+  _data.resize(wordsAfter, Word{0U});
+
+  // Move the words from the top down, so that no source word is overwritten
+  // before it is read. Each word combines two source words with a funnel
+  // shift.
+  for (usize w = wordsAfter; w > wordShift; --w) {
+    const usize src = w - 1U - wordShift;
+    Word word       = _data[src] << bitShift;
+    if (bitShift != 0U && src > 0U) {
+      word |= _data[src - 1U] >> (BitsPerWord - bitShift);
+    }
+    _data[w - 1U] = word;
+  }
+  std::fill_n(_data.begin(), wordShift, Word{0U});
+  _size = sizeBefore + usize(i);
+  _clearTail();
 
   CONTRACT_ASSERT(sizeBefore + usize(i) == size());
   return *this;
 }
 
 BitVector &BitVector::operator>>=(int i) {
-  const auto sizeBefore [[maybe_unused]] = _data.size();
-  _data.erase(_data.begin(), _data.begin() + i);
+  const auto sizeBefore [[maybe_unused]] = _size;
+  const usize wordShift                  = usize(i) / BitsPerWord;
+  const usize bitShift                   = usize(i) % BitsPerWord;
+  const usize wordsBefore                = _data.size();
+
+  // Move the words from the bottom up, see 'operator<<='.
+  for (usize w = 0U; w + wordShift < wordsBefore; ++w) {
+    const usize src = w + wordShift;
+    Word word       = _data[src] >> bitShift;
+    if (bitShift != 0U && src + 1U < wordsBefore) {
+      word |= _data[src + 1U] << (BitsPerWord - bitShift);
+    }
+    _data[w] = word;
+  }
+  // Shrinking keeps the capacity.
+  resize(_size - usize(i));
 
   CONTRACT_ASSERT(sizeBefore - usize(i) == size());
   return *this;
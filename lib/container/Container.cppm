@@ -2,4 +2,7 @@ export module jt.Container;
 
 export import jt.Core;
 
+export import :AtomicBitVector;
 export import :BitVector;
+export import :RankSelect;
+export import :RoaringBitmap;
@@ -0,0 +1,162 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Container:RankSelect;
+
+import :BitVector;
+
+import std;
+import jt.Core;
+
+using namespace std;
+
+namespace jt::container {
+
+/// Succinct index for @c rank and @c select queries on a @c BitVector.
+///
+/// The bits are grouped into superblocks of 4096 bits, each storing the
+/// number of set bits before it, and blocks of 512 bits, that store their
+/// count relative to the superblock in 16 bits. This costs less than 5% of the
+/// memory of the bits. Every 8192-th set bit is additionally sampled with its
+/// superblock, to narrow the search of @c select.
+///
+/// The index is built in one pass over the words. It references the
+/// @c BitVector, which must outlive the index and must not be modified.
+export class RankSelectIndex {
+public:
+  explicit RankSelectIndex(const BitVector &bits);
+  RankSelectIndex(BitVector &&bits) = delete;
+
+  /// Return the number of set bits.
+  [[nodiscard]] usize count() const noexcept { return _count; }
+
+  /// Return the number of set bits within @c [0, index).
+  [[nodiscard]] usize rank(usize index) const PRE(index <= _bits->size());
+
+  /// Return the index of the set bit with @c rank(index) == k, i.e. the
+  /// position of the @c k-th set bit counting from zero.
+  [[nodiscard]] usize select(usize k) const PRE(k < count());
+
+  /// Return the number of bytes the index needs in addition to the bits.
+  [[nodiscard]] usize byteSize() const noexcept {
+    return _superblocks.size() * sizeof(Superblock) +
+           _selectSamples.size() * sizeof(u32);
+  }
+
+private:
+  static constexpr usize wordsPerBlock      = 8U;
+  static constexpr usize blocksPerSuper     = 8U;
+  static constexpr usize wordsPerSuperblock = wordsPerBlock * blocksPerSuper;
+  static constexpr usize selectSampleRate   = 8192U;
+
+  struct Superblock {
+    u64 rank;
+    /// Set bits before each block, relative to @c rank.
+    array<u16, blocksPerSuper> blockRanks;
+  };
+
+  const BitVector *_bits;
+  vector<Superblock> _superblocks;
+  /// Superblock that contains the set bit @c i*selectSampleRate.
+  vector<u32> _selectSamples;
+  usize _count{0U};
+};
+
+RankSelectIndex::RankSelectIndex(const BitVector &bits) : _bits{&bits} {
+  const auto words = bits.words();
+  _superblocks.reserve(words.size() / wordsPerSuperblock + 1U);
+
+  for (usize w = 0U; w < words.size(); ++w) {
+    if (w % wordsPerSuperblock == 0U) {
+      _superblocks.push_back({_count, {}});
+    }
+    auto &superblock = _superblocks.back();
+    if (w % wordsPerBlock == 0U) {
+      superblock.blockRanks[(w % wordsPerSuperblock) / wordsPerBlock] =
+          static_cast<u16>(_count - superblock.rank);
+    }
+
+    const auto ones = static_cast<usize>(popcount(words[w]));
+    // Sample the superblocks that contain a multiple of the sample rate.
+    for (usize next = _selectSamples.size() * selectSampleRate;
+         next < _count + ones; next += selectSampleRate) {
+      _selectSamples.push_back(static_cast<u32>(_superblocks.size() - 1U));
+    }
+    _count += ones;
+  }
+  // Blocks past the end of the bits repeat the last count, so that rank
+  // and select never need to check the number of blocks.
+  if (!_superblocks.empty()) {
+    auto &last = _superblocks.back();
+    const usize usedBlocks =
+        (words.size() - 1U) % wordsPerSuperblock / wordsPerBlock + 1U;
+    for (usize b = usedBlocks; b < blocksPerSuper; ++b) {
+      last.blockRanks[b] = static_cast<u16>(_count - last.rank);
+    }
+  }
+}
+
+usize RankSelectIndex::rank(usize index) const {
+  const auto words      = _bits->words();
+  const usize wordIndex = index / BitVector::BitsPerWord;
+  if (wordIndex >= words.size()) {
+    return _count;
+  }
+
+  const auto &superblock = _superblocks[wordIndex / wordsPerSuperblock];
+  const usize block      = (wordIndex % wordsPerSuperblock) / wordsPerBlock;
+  usize result           = superblock.rank + superblock.blockRanks[block];
+  for (usize w = wordIndex - wordIndex % wordsPerBlock; w < wordIndex; ++w) {
+    result += static_cast<usize>(popcount(words[w]));
+  }
+  const usize bit = index % BitVector::BitsPerWord;
+  if (bit != 0U) {
+    const u64 below = words[wordIndex] << (BitVector::BitsPerWord - bit);
+    result += static_cast<usize>(popcount(below));
+  }
+  return result;
+}
+
+usize RankSelectIndex::select(usize k) const {
+  const auto words = _bits->words();
+
+  // 1. Binary search for the superblock between the neighbouring samples.
+  const usize sample = k / selectSampleRate;
+  const auto first   = _superblocks.begin() + _selectSamples[sample];
+  const auto last =
+      sample + 1U < _selectSamples.size()
+          ? _superblocks.begin() + _selectSamples[sample + 1U] + 1
+          : _superblocks.end();
+  const auto superblock =
+      prev(upper_bound(first, last, k, [](usize value, const Superblock &s) {
+        return value < s.rank;
+      }));
+  usize remaining = k - superblock->rank;
+
+  // 2. Find the block within the superblock.
+  usize block = 0U;
+  while (block + 1U < blocksPerSuper &&
+         superblock->blockRanks[block + 1U] <= remaining) {
+    ++block;
+  }
+  remaining -= superblock->blockRanks[block];
+
+  // 3. Find the word within the block.
+  usize w = static_cast<usize>(superblock - _superblocks.begin()) *
+                wordsPerSuperblock +
+            block * wordsPerBlock;
+  for (auto ones = static_cast<usize>(popcount(words[w])); ones <= remaining;
+       ones      = static_cast<usize>(popcount(words[++w]))) {
+    remaining -= ones;
+  }
+
+  // 4. Clear the lower set bits within the word.
+  u64 word = words[w];
+  for (; remaining > 0U; --remaining) {
+    word &= word - 1U;
+  }
+  return w * BitVector::BitsPerWord + static_cast<usize>(countr_zero(word));
+}
+
+} // namespace jt::container
@@ -0,0 +1,514 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Container:RoaringBitmap;
+
+import :BitVector;
+
+import std;
+import jt.Core;
+
+using namespace std;
+
+namespace jt::container {
+
+/// Sorted lower 16 bits of the values of a sparse chunk.
+struct ArrayChunk {
+  vector<u16> values;
+};
+
+/// One bit for each of the 65536 values of a dense chunk.
+struct BitmapChunk {
+  static constexpr usize wordCount = 1024U;
+  vector<u64> words                = vector<u64>(wordCount, 0U);
+  /// Number of set bits, so that single bit updates do not count all words.
+  usize count{0U};
+
+  /// Set @c count after modifying whole words.
+  void recount() {
+    count = 0U;
+    for (const u64 word : words) {
+      count += static_cast<usize>(popcount(word));
+    }
+  }
+};
+
+/// Inclusive intervals of values of a chunk that consists of long runs.
+struct RunChunk {
+  struct Run {
+    u16 first;
+    u16 last;
+  };
+  vector<Run> runs;
+};
+
+using Chunk = variant<ArrayChunk, BitmapChunk, RunChunk>;
+
+/// Calls @c f with the lower 16 bits of every value in @c chunk in ascending
+/// order.
+template <typename F> void forEachInChunk(const Chunk &chunk, F &&f) {
+  if (const auto *array = get_if<ArrayChunk>(&chunk)) {
+    for (const u16 value : array->values) {
+      f(value);
+    }
+  } else if (const auto *bitmap = get_if<BitmapChunk>(&chunk)) {
+    for (usize w = 0U; w < bitmap->words.size(); ++w) {
+      for (u64 word = bitmap->words[w]; word != 0U; word &= word - 1U) {
+        f(static_cast<u16>(w * 64U + static_cast<usize>(countr_zero(word))));
+      }
+    }
+  } else {
+    for (const auto run : get<RunChunk>(chunk).runs) {
+      for (u32 value = run.first; value <= run.last; ++value) {
+        f(static_cast<u16>(value));
+      }
+    }
+  }
+}
+
+/// Compressed set of @c u32 values.
+///
+/// The values are split by their upper 16 bits into chunks of 65536 values.
+/// Each chunk picks the smallest of three representations: a sorted array
+/// for up to 4096 values, a bitmap of 8 KiB for more values, or a list of
+/// runs for long stretches of consecutive values. Empty chunks are not
+/// stored at all.
+/// Union and intersection work chunk by chunk and only combine chunks with
+/// the same upper bits.
+/// @note Run chunks are only created by @c runOptimize and the construction
+/// from a @c BitVector. Modifying a run chunk converts it back.
+export class RoaringBitmap {
+public:
+  RoaringBitmap() = default;
+
+  /// Construct the set of indices of the set bits of @c bits.
+  /// @pre bits.size() <= 2^32
+  explicit RoaringBitmap(const BitVector &bits)
+      PRE(bits.size() <= (usize{1U} << 32U));
+
+  /// Add @c value to the set.
+  void add(u32 value);
+
+  /// Remove @c value from the set.
+  void remove(u32 value);
+
+  /// Returns @c true if @c value is in the set.
+  [[nodiscard]] bool contains(u32 value) const;
+
+  /// Return the number of values in the set.
+  [[nodiscard]] usize count() const;
+
+  [[nodiscard]] bool empty() const noexcept { return _keys.empty(); }
+
+  /// Convert each chunk to the representation that needs the least memory,
+  /// including run-length encoding.
+  void runOptimize();
+
+  /// Return the number of bytes for the values of all chunks.
+  [[nodiscard]] usize byteSize() const;
+
+  /// Calls @c f with every value in ascending order.
+  template <invocable<u32> F> void forEach(F &&f) const {
+    for (usize c = 0U; c < _keys.size(); ++c) {
+      const u32 high = u32{_keys[c]} << 16U;
+      forEachInChunk(_chunks[c], [&f, high](u16 low) { f(high | low); });
+    }
+  }
+
+  /// Return a @c BitVector of @c size bits, that has the bits of all values
+  /// below @c size set.
+  [[nodiscard]] BitVector toBitVector(usize size) const;
+
+  /// Union and intersection with another set.
+  RoaringBitmap &operator|=(const RoaringBitmap &other);
+  RoaringBitmap &operator&=(const RoaringBitmap &other);
+
+  /// Compare the values of two sets, independent of their representation.
+  [[nodiscard]] bool operator==(const RoaringBitmap &other) const;
+
+private:
+  /// Return the position of the chunk for @c key, or the position where it
+  /// would be inserted.
+  [[nodiscard]] usize _position(u16 key) const;
+
+  /// Upper 16 bits of the values of each chunk in ascending order.
+  vector<u16> _keys;
+  vector<Chunk> _chunks;
+};
+
+export RoaringBitmap operator|(RoaringBitmap a, const RoaringBitmap &b) {
+  return a |= b;
+}
+export RoaringBitmap operator&(RoaringBitmap a, const RoaringBitmap &b) {
+  return a &= b;
+}
+
+constexpr usize maxArraySize = 4096U;
+
+usize cardinality(const BitmapChunk &bitmap) { return bitmap.count; }
+
+usize cardinality(const Chunk &chunk) {
+  if (const auto *array = get_if<ArrayChunk>(&chunk)) {
+    return array->values.size();
+  }
+  if (const auto *bitmap = get_if<BitmapChunk>(&chunk)) {
+    return cardinality(*bitmap);
+  }
+  usize result = 0U;
+  for (const auto run : get<RunChunk>(chunk).runs) {
+    result += usize{run.last} - usize{run.first} + 1U;
+  }
+  return result;
+}
+
+bool chunkContains(const Chunk &chunk, u16 low) {
+  if (const auto *array = get_if<ArrayChunk>(&chunk)) {
+    return ranges::binary_search(array->values, low);
+  }
+  if (const auto *bitmap = get_if<BitmapChunk>(&chunk)) {
+    return ((bitmap->words[low / 64U] >> (low % 64U)) & 1U) != 0U;
+  }
+  const auto &runs = get<RunChunk>(chunk).runs;
+  const auto run =
+      ranges::upper_bound(runs, low, less{}, &RunChunk::Run::first);
+  return run != runs.begin() && prev(run)->last >= low;
+}
+
+BitmapChunk toBitmap(const Chunk &chunk) {
+  if (const auto *bitmap = get_if<BitmapChunk>(&chunk)) {
+    return *bitmap;
+  }
+  auto result = BitmapChunk{};
+  forEachInChunk(chunk, [&result](u16 low) {
+    result.words[low / 64U] |= u64{1U} << (low % 64U);
+  });
+  result.count = cardinality(chunk);
+  return result;
+}
+
+/// Store sparse bitmaps as array.
+Chunk shrink(BitmapChunk bitmap) {
+  if (cardinality(bitmap) > maxArraySize) {
+    return bitmap;
+  }
+  auto array = ArrayChunk{};
+  forEachInChunk(Chunk{std::move(bitmap)},
+                 [&array](u16 low) { array.values.push_back(low); });
+  return array;
+}
+
+RunChunk toRuns(const Chunk &chunk) {
+  auto result = RunChunk{};
+  forEachInChunk(chunk, [&result](u16 low) {
+    if (!result.runs.empty() && u32{result.runs.back().last} + 1U == low) {
+      result.runs.back().last = low;
+    } else {
+      result.runs.push_back({low, low});
+    }
+  });
+  return result;
+}
+
+Chunk unite(const Chunk &a, const Chunk &b) {
+  if (holds_alternative<RunChunk>(a) && holds_alternative<RunChunk>(b)) {
+    // Merge the runs by their start and join overlapping or adjacent runs.
+    const auto &runsA = get<RunChunk>(a).runs;
+    const auto &runsB = get<RunChunk>(b).runs;
+    auto merged       = vector<RunChunk::Run>{};
+    merged.reserve(runsA.size() + runsB.size());
+    ranges::merge(runsA, runsB, back_inserter(merged), less{},
+                  &RunChunk::Run::first, &RunChunk::Run::first);
+
+    auto result = RunChunk{};
+    for (const auto run : merged) {
+      if (!result.runs.empty() &&
+          u32{run.first} <= u32{result.runs.back().last} + 1U) {
+        result.runs.back().last = max(result.runs.back().last, run.last);
+      } else {
+        result.runs.push_back(run);
+      }
+    }
+    return result;
+  }
+  if (holds_alternative<ArrayChunk>(a) && holds_alternative<ArrayChunk>(b)) {
+    const auto &valuesA = get<ArrayChunk>(a).values;
+    const auto &valuesB = get<ArrayChunk>(b).values;
+    if (valuesA.size() + valuesB.size() <= maxArraySize) {
+      auto result = ArrayChunk{};
+      ranges::set_union(valuesA, valuesB, back_inserter(result.values));
+      return result;
+    }
+  }
+  auto result       = toBitmap(a);
+  const auto bitmap = toBitmap(b);
+  for (usize w = 0U; w < BitmapChunk::wordCount; ++w) {
+    result.words[w] |= bitmap.words[w];
+  }
+  result.recount();
+  return shrink(std::move(result));
+}
+
+Chunk intersect(const Chunk &a, const Chunk &b) {
+  if (holds_alternative<RunChunk>(a) && holds_alternative<RunChunk>(b)) {
+    const auto &runsA = get<RunChunk>(a).runs;
+    const auto &runsB = get<RunChunk>(b).runs;
+    auto result       = RunChunk{};
+    for (usize i = 0U, j = 0U; i < runsA.size() && j < runsB.size();) {
+      const u16 first = max(runsA[i].first, runsB[j].first);
+      const u16 last  = min(runsA[i].last, runsB[j].last);
+      if (first <= last) {
+        result.runs.push_back({first, last});
+      }
+      // The run that ends first can not overlap with any later run.
+      if (runsA[i].last < runsB[j].last) {
+        ++i;
+      } else {
+        ++j;
+      }
+    }
+    return result;
+  }
+  // Arrays stay arrays, only their values have to be looked up.
+  if (const auto *array = get_if<ArrayChunk>(&a)) {
+    auto result = ArrayChunk{};
+    ranges::copy_if(array->values, back_inserter(result.values),
+                    [&b](u16 low) { return chunkContains(b, low); });
+    return result;
+  }
+  if (holds_alternative<ArrayChunk>(b)) {
+    return intersect(b, a);
+  }
+  auto result       = toBitmap(a);
+  const auto bitmap = toBitmap(b);
+  for (usize w = 0U; w < BitmapChunk::wordCount; ++w) {
+    result.words[w] &= bitmap.words[w];
+  }
+  result.recount();
+  return shrink(std::move(result));
+}
+
+RoaringBitmap::RoaringBitmap(const BitVector &bits) {
+  const auto words = bits.words();
+  for (usize first = 0U; first < words.size();
+       first += BitmapChunk::wordCount) {
+    const auto chunkWords =
+        words.subspan(first, min(BitmapChunk::wordCount, words.size() - first));
+    if (ranges::all_of(chunkWords, [](u64 word) { return word == 0U; })) {
+      continue;
+    }
+    auto bitmap = BitmapChunk{};
+    ranges::copy(chunkWords, bitmap.words.begin());
+    bitmap.recount();
+    _keys.push_back(static_cast<u16>(first / BitmapChunk::wordCount));
+    _chunks.push_back(shrink(std::move(bitmap)));
+  }
+  runOptimize();
+}
+
+usize RoaringBitmap::_position(u16 key) const {
+  return static_cast<usize>(ranges::lower_bound(_keys, key) - _keys.begin());
+}
+
+void RoaringBitmap::add(u32 value) {
+  const auto key = static_cast<u16>(value >> 16U);
+  const auto low = static_cast<u16>(value);
+  const usize i  = _position(key);
+  if (i == _keys.size() || _keys[i] != key) {
+    _keys.insert(_keys.begin() + static_cast<pdiff>(i), key);
+    _chunks.insert(_chunks.begin() + static_cast<pdiff>(i),
+                   ArrayChunk{{low}});
+    return;
+  }
+
+  auto &chunk = _chunks[i];
+  if (holds_alternative<RunChunk>(chunk)) {
+    chunk = shrink(toBitmap(chunk));
+  }
+  if (auto *array = get_if<ArrayChunk>(&chunk)) {
+    const auto it = ranges::lower_bound(array->values, low);
+    if (it != array->values.end() && *it == low) {
+      return;
+    }
+    array->values.insert(it, low);
+    if (array->values.size() > maxArraySize) {
+      chunk = toBitmap(chunk);
+    }
+    return;
+  }
+  auto &bitmap  = get<BitmapChunk>(chunk);
+  auto &word    = bitmap.words[low / 64U];
+  const u64 bit = u64{1U} << (low % 64U);
+  if ((word & bit) == 0U) {
+    word |= bit;
+    ++bitmap.count;
+  }
+}
+
+void RoaringBitmap::remove(u32 value) {
+  const auto key = static_cast<u16>(value >> 16U);
+  const auto low = static_cast<u16>(value);
+  const usize i  = _position(key);
+  if (i == _keys.size() || _keys[i] != key) {
+    return;
+  }
+
+  auto &chunk = _chunks[i];
+  if (holds_alternative<RunChunk>(chunk)) {
+    chunk = shrink(toBitmap(chunk));
+  }
+  if (auto *array = get_if<ArrayChunk>(&chunk)) {
+    const auto it = ranges::lower_bound(array->values, low);
+    if (it != array->values.end() && *it == low) {
+      array->values.erase(it);
+    }
+  } else {
+    auto &bitmap  = get<BitmapChunk>(chunk);
+    auto &word    = bitmap.words[low / 64U];
+    const u64 bit = u64{1U} << (low % 64U);
+    if ((word & bit) == 0U) {
+      return;
+    }
+    word &= ~bit;
+    --bitmap.count;
+    if (cardinality(bitmap) <= maxArraySize) {
+      chunk = shrink(std::move(bitmap));
+    }
+  }
+
+  if (cardinality(chunk) == 0U) {
+    _keys.erase(_keys.begin() + static_cast<pdiff>(i));
+    _chunks.erase(_chunks.begin() + static_cast<pdiff>(i));
+  }
+}
+
+bool RoaringBitmap::contains(u32 value) const {
+  const auto key = static_cast<u16>(value >> 16U);
+  const usize i  = _position(key);
+  return i < _keys.size() && _keys[i] == key &&
+         chunkContains(_chunks[i], static_cast<u16>(value));
+}
+
+usize RoaringBitmap::count() const {
+  usize result = 0U;
+  for (const auto &chunk : _chunks) {
+    result += cardinality(chunk);
+  }
+  return result;
+}
+
+/// Return the bytes for the values of @c chunk.
+usize chunkBytes(const Chunk &chunk) {
+  if (const auto *array = get_if<ArrayChunk>(&chunk)) {
+    return array->values.size() * sizeof(u16);
+  }
+  if (const auto *bitmap = get_if<BitmapChunk>(&chunk)) {
+    return bitmap->words.size() * sizeof(u64);
+  }
+  return get<RunChunk>(chunk).runs.size() * sizeof(RunChunk::Run);
+}
+
+void RoaringBitmap::runOptimize() {
+  for (auto &chunk : _chunks) {
+    auto runs             = toRuns(chunk);
+    const usize runBytes  = runs.runs.size() * sizeof(RunChunk::Run);
+    const usize cardinal  = cardinality(chunk);
+    const usize flatBytes = cardinal <= maxArraySize
+                                ? cardinal * sizeof(u16)
+                                : BitmapChunk::wordCount * sizeof(u64);
+    if (runBytes < flatBytes) {
+      chunk = std::move(runs);
+    } else if (holds_alternative<RunChunk>(chunk)) {
+      chunk = shrink(toBitmap(chunk));
+    }
+  }
+}
+
+usize RoaringBitmap::byteSize() const {
+  usize result = _keys.size() * (sizeof(u16) + sizeof(Chunk));
+  for (const auto &chunk : _chunks) {
+    result += chunkBytes(chunk);
+  }
+  return result;
+}
+
+BitVector RoaringBitmap::toBitVector(usize size) const {
+  auto bits  = BitVector{size, /*initialValue=*/false};
+  auto words = bits.words();
+  for (usize c = 0U; c < _keys.size(); ++c) {
+    const usize firstWord = usize{_keys[c]} * BitmapChunk::wordCount;
+    const auto *bitmap    = get_if<BitmapChunk>(&_chunks[c]);
+    // Whole bitmaps are copied word by word, all other chunks value by value.
+    if (bitmap != nullptr &&
+        firstWord + BitmapChunk::wordCount <= size / BitVector::BitsPerWord) {
+      ranges::copy(bitmap->words,
+                   words.begin() + static_cast<pdiff>(firstWord));
+      continue;
+    }
+    const usize high = usize{_keys[c]} << 16U;
+    forEachInChunk(_chunks[c], [&bits, high, size](u16 low) {
+      if (high + low < size) {
+        bits.set(high + low, true);
+      }
+    });
+  }
+  return bits;
+}
+
+RoaringBitmap &RoaringBitmap::operator|=(const RoaringBitmap &other) {
+  auto keys   = vector<u16>{};
+  auto chunks = vector<Chunk>{};
+  usize i     = 0U;
+  usize j     = 0U;
+  while (i < _keys.size() || j < other._keys.size()) {
+    if (j == other._keys.size() ||
+        (i < _keys.size() && _keys[i] < other._keys[j])) {
+      keys.push_back(_keys[i]);
+      chunks.push_back(std::move(_chunks[i++]));
+    } else if (i == _keys.size() || other._keys[j] < _keys[i]) {
+      keys.push_back(other._keys[j]);
+      chunks.push_back(other._chunks[j++]);
+    } else {
+      keys.push_back(_keys[i]);
+      chunks.push_back(unite(_chunks[i++], other._chunks[j++]));
+    }
+  }
+  _keys   = std::move(keys);
+  _chunks = std::move(chunks);
+  return *this;
+}
+
+RoaringBitmap &RoaringBitmap::operator&=(const RoaringBitmap &other) {
+  auto keys   = vector<u16>{};
+  auto chunks = vector<Chunk>{};
+  for (usize i = 0U, j = 0U; i < _keys.size() && j < other._keys.size();) {
+    if (_keys[i] < other._keys[j]) {
+      ++i;
+    } else if (other._keys[j] < _keys[i]) {
+      ++j;
+    } else {
+      auto chunk = intersect(_chunks[i++], other._chunks[j++]);
+      if (cardinality(chunk) != 0U) {
+        keys.push_back(_keys[i - 1U]);
+        chunks.push_back(std::move(chunk));
+      }
+    }
+  }
+  _keys   = std::move(keys);
+  _chunks = std::move(chunks);
+  return *this;
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap &other) const {
+  if (_keys != other._keys) {
+    return false;
+  }
+  for (usize c = 0U; c < _chunks.size(); ++c) {
+    if (toBitmap(_chunks[c]).words != toBitmap(other._chunks[c]).words) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace jt::container
@@ -1,4 +1,7 @@
 export module jt.Core;
 
 export import :Constants;
+export import :CpuFeatures;
+export import :MappedFile;
+export import :Parallel;
 export import :Types;
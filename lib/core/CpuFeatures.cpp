@@ -0,0 +1,245 @@
+module;
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+export module jt.Core:CpuFeatures;
+
+import :Types;
+
+import std;
+
+using namespace std;
+
+export namespace jt {
+
+/// Instruction set extensions, that kernels can be specialized for.
+enum class CpuFeature : u8 {
+  SSSE3,
+  SSE41,
+  AVX,
+  AVX2,
+  BMI2,
+  ADX,
+  AVX512F,
+  SHA,
+};
+
+/// Name of @c feature in lower case, as used by the compiler flags, e.g.
+/// @c -mbmi2, and the environment override.
+constexpr string_view cpuFeatureName(CpuFeature feature) noexcept {
+  constexpr auto names = array<string_view, 8>{
+      "ssse3", "sse4.1", "avx", "avx2", "bmi2", "adx", "avx512f", "sha"};
+  return names[static_cast<usize>(feature)];
+}
+
+/// Environment variable with a comma separated list of features, that are
+/// treated as unavailable, or @c all to use only the portable
+/// implementations. This allows testing every implementation on one machine.
+constexpr auto cpuFeatureOverrideVariable = "JT_DISABLE_CPU_FEATURES"sv;
+
+/// Set of @c CpuFeature.
+class CpuFeatureSet {
+public:
+  constexpr CpuFeatureSet() = default;
+  constexpr CpuFeatureSet(initializer_list<CpuFeature> features) {
+    for (const auto feature : features) {
+      _bits |= _bit(feature);
+    }
+  }
+
+  /// Returns @c true if @c feature is in the set.
+  [[nodiscard]] constexpr bool has(CpuFeature feature) const noexcept {
+    return (_bits & _bit(feature)) != 0U;
+  }
+
+  /// Returns @c true if all features of @c other are in this set.
+  [[nodiscard]] constexpr bool contains(CpuFeatureSet other) const noexcept {
+    return (_bits & other._bits) == other._bits;
+  }
+
+  /// Returns the features of this set, that are not in @c other.
+  [[nodiscard]] constexpr CpuFeatureSet
+  without(CpuFeatureSet other) const noexcept {
+    auto result  = *this;
+    result._bits = _bits & ~other._bits;
+    return result;
+  }
+
+  [[nodiscard]] constexpr bool empty() const noexcept { return _bits == 0U; }
+
+  constexpr bool operator==(const CpuFeatureSet &) const noexcept = default;
+
+  /// Returns the set of all known features.
+  [[nodiscard]] static constexpr CpuFeatureSet all() noexcept {
+    auto result  = CpuFeatureSet{};
+    result._bits = (u32{1U} << featureCount) - 1U;
+    return result;
+  }
+
+  /// Parse a comma separated list of feature names, or @c all.
+  /// Spaces are ignored and the names are case sensitive.
+  /// @throws invalid_argument for unknown names.
+  [[nodiscard]] static CpuFeatureSet parse(string_view names) {
+    return _parse(names, true);
+  }
+
+  /// Parse the names like @c parse, but skip unknown names, e.g. names of
+  /// features that a newer version knows.
+  [[nodiscard]] static CpuFeatureSet parseKnown(string_view names) {
+    return _parse(names, false);
+  }
+
+  /// Query the features of the processor with @c cpuid. Extensions that need
+  /// operating system support for their registers, like AVX, are only
+  /// reported if the system enabled them.
+  [[nodiscard]] static CpuFeatureSet detect() noexcept;
+
+  /// Return the detected features without the ones disabled by the
+  /// environment variable @c JT_DISABLE_CPU_FEATURES.
+  /// The result is determined once and then cached. Unknown names in the
+  /// variable are ignored, the known ones are still disabled.
+  [[nodiscard]] static const CpuFeatureSet &host() {
+    static const auto features = []() {
+      const auto *disabled = getenv(cpuFeatureOverrideVariable.data());
+      if (disabled == nullptr) {
+        return detect();
+      }
+      return detect().without(parseKnown(disabled));
+    }();
+    return features;
+  }
+
+private:
+  static constexpr usize featureCount = 8U;
+
+  [[nodiscard]] static constexpr u32 _bit(CpuFeature feature) noexcept {
+    return u32{1U} << static_cast<u32>(feature);
+  }
+  [[nodiscard]] static optional<CpuFeature> _byName(string_view name) {
+    for (usize i = 0U; i < featureCount; ++i) {
+      const auto feature = static_cast<CpuFeature>(i);
+      if (cpuFeatureName(feature) == name) {
+        return feature;
+      }
+    }
+    return nullopt;
+  }
+
+  /// Parse @c names and either reject or skip unknown names.
+  [[nodiscard]] static CpuFeatureSet _parse(string_view names,
+                                            bool rejectUnknown) {
+    auto result = CpuFeatureSet{};
+    for (const auto part : views::split(names, ',')) {
+      auto name = string_view{part};
+      while (!name.empty() && name.front() == ' ') {
+        name.remove_prefix(1U);
+      }
+      while (!name.empty() && name.back() == ' ') {
+        name.remove_suffix(1U);
+      }
+      if (name.empty()) {
+        continue;
+      }
+      if (name == "all") {
+        return all();
+      }
+      const auto feature = _byName(name);
+      if (feature) {
+        result._bits |= _bit(*feature);
+      } else if (rejectUnknown) {
+        throw invalid_argument{"Unknown CPU feature '" + string{name} + "'"};
+      }
+    }
+    return result;
+  }
+
+  u32 _bits{0U};
+};
+
+/// One implementation of a kernel, that requires the features @c required.
+template <typename Function> struct Implementation {
+  string_view name;
+  CpuFeatureSet required;
+  Function *function;
+};
+
+/// Return the first of @c implementations, whose required features are all
+/// in @c available. The implementations are ordered from the best to the
+/// portable one, which should require no features at all.
+/// Kernels resolve their implementation once and keep the function pointer:
+/// @code
+/// static const auto &impl = selectImplementation(span{implementations});
+/// impl.function(...);
+/// @endcode
+/// @throws logic_error if no implementation is supported.
+template <typename Function, usize Extent>
+const Implementation<Function> &selectImplementation(
+    span<const Implementation<Function>, Extent> implementations,
+    const CpuFeatureSet &available = CpuFeatureSet::host()) {
+  for (const auto &implementation : implementations) {
+    if (available.contains(implementation.required)) {
+      return implementation;
+    }
+  }
+  throw logic_error{"No implementation is supported by this CPU"};
+}
+
+} // namespace jt
+
+namespace jt {
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Return the register state the operating system saves on context switches.
+u64 readXcr0() noexcept {
+  u32 eax = 0U;
+  u32 edx = 0U;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0U));
+  return (u64{edx} << 32U) | eax;
+}
+
+CpuFeatureSet CpuFeatureSet::detect() noexcept {
+  auto result  = CpuFeatureSet{};
+  unsigned eax = 0U;
+  unsigned ebx = 0U;
+  unsigned ecx = 0U;
+  unsigned edx = 0U;
+  if (__get_cpuid(1U, &eax, &ebx, &ecx, &edx) == 0) {
+    return result;
+  }
+  const auto set = [&result](CpuFeature feature, bool available) {
+    if (available) {
+      result._bits |= _bit(feature);
+    }
+  };
+  const auto bit = [](unsigned reg, unsigned index) {
+    return ((reg >> index) & 1U) != 0U;
+  };
+
+  set(CpuFeature::SSSE3, bit(ecx, 9U));
+  set(CpuFeature::SSE41, bit(ecx, 19U));
+
+  // The SSE and AVX registers, and the AVX-512 mask and upper registers.
+  const bool osxsave     = bit(ecx, 27U);
+  const u64 xcr0         = osxsave ? readXcr0() : 0U;
+  const bool avxState    = (xcr0 & 0x6U) == 0x6U;
+  const bool avx512State = (xcr0 & 0xE6U) == 0xE6U;
+  const bool avx         = bit(ecx, 28U) && avxState;
+  set(CpuFeature::AVX, avx);
+
+  if (__get_cpuid_count(7U, 0U, &eax, &ebx, &ecx, &edx) == 0) {
+    return result;
+  }
+  set(CpuFeature::AVX2, avx && bit(ebx, 5U));
+  set(CpuFeature::BMI2, bit(ebx, 8U));
+  set(CpuFeature::AVX512F, avx512State && bit(ebx, 16U));
+  set(CpuFeature::ADX, bit(ebx, 19U));
+  set(CpuFeature::SHA, bit(ebx, 29U));
+  return result;
+}
+#else
+CpuFeatureSet CpuFeatureSet::detect() noexcept { return {}; }
+#endif
+
+} // namespace jt
@@ -0,0 +1,243 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module jt.Core:MappedFile;
+
+import :Types;
+
+import std;
+
+using namespace std;
+
+namespace jt {
+
+/// Owner of a file descriptor, that is closed on destruction.
+class FileDescriptor {
+public:
+  explicit FileDescriptor(const filesystem::path &path)
+      : _fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)} {
+    if (_fd < 0) {
+      throw system_error{errno, generic_category(),
+                         "Can not open '" + path.string() + "'"};
+    }
+  }
+  FileDescriptor(const FileDescriptor &)            = delete;
+  FileDescriptor &operator=(const FileDescriptor &) = delete;
+  FileDescriptor(FileDescriptor &&other) noexcept
+      : _fd{exchange(other._fd, -1)} {}
+  FileDescriptor &operator=(FileDescriptor &&) = delete;
+  ~FileDescriptor() {
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  [[nodiscard]] int get() const noexcept { return _fd; }
+
+  [[nodiscard]] struct ::stat status(const filesystem::path &path) const {
+    struct ::stat result{};
+    if (::fstat(_fd, &result) != 0) {
+      throw system_error{errno, generic_category(),
+                         "Can not stat '" + path.string() + "'"};
+    }
+    return result;
+  }
+
+private:
+  int _fd;
+};
+
+} // namespace jt
+
+export namespace jt {
+
+/// Expected access pattern of a mapping, that is passed to the operating
+/// system as advice for reading ahead.
+enum class FileAccess : u8 {
+  Normal,
+  /// The file is read front to back, pages are read ahead aggressively and
+  /// may be dropped soon after they were accessed.
+  Sequential,
+  /// The file is accessed at random positions, reading ahead is disabled.
+  Random,
+};
+
+/// Read-only memory mapping of a whole file.
+///
+/// The pages are loaded lazily by the operating system and shared with the
+/// page cache, opening a file is therefore independent of its size.
+/// The mapping is released on destruction.
+/// @sa FileReader to read files, that can not be mapped.
+class MappedFile {
+public:
+  /// Maps the file at @c path into memory.
+  /// @throws system_error if the file can not be opened or mapped.
+  explicit MappedFile(const filesystem::path &path,
+                      FileAccess access = FileAccess::Normal) {
+    const auto file = FileDescriptor{path};
+    _map(file, static_cast<usize>(file.status(path).st_size), access, path);
+  }
+
+  MappedFile(const MappedFile &)            = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept
+      : _data{exchange(other._data, nullptr)},
+        _size{exchange(other._size, 0U)} {}
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      _unmap();
+      _data = exchange(other._data, nullptr);
+      _size = exchange(other._size, 0U);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { _unmap(); }
+
+  /// Returns the content of the file.
+  [[nodiscard]] span<const byte> bytes() const noexcept {
+    return {_data, _size};
+  }
+  [[nodiscard]] usize size() const noexcept { return _size; }
+
+private:
+  friend class FileReader;
+
+  MappedFile() = default;
+
+  void _map(const FileDescriptor &file, usize size, FileAccess access,
+            const filesystem::path &path) {
+    _size = size;
+    // Mapping an empty file is an error, but an empty span is fine.
+    // The mapping stays valid after the descriptor is closed.
+    if (_size == 0U) {
+      return;
+    }
+    void *data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file.get(), 0);
+    if (data == MAP_FAILED) {
+      _size = 0U;
+      throw system_error{errno, generic_category(),
+                         "Can not map '" + path.string() + "'"};
+    }
+    _data = static_cast<const byte *>(data);
+
+    // The advice is only a hint, failing to give it is not an error.
+    if (access == FileAccess::Sequential) {
+      ::madvise(data, _size, MADV_SEQUENTIAL);
+    } else if (access == FileAccess::Random) {
+      ::madvise(data, _size, MADV_RANDOM);
+    }
+  }
+
+  void _unmap() noexcept {
+    if (_data != nullptr) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+      ::munmap(const_cast<byte *>(_data), _size);
+    }
+  }
+
+  const byte *_data{nullptr};
+  usize _size{0U};
+};
+
+/// Reads a whole file front to back in contiguous chunks.
+///
+/// Regular files are mapped for sequential access on the first call of
+/// @c next and returned as a single chunk. Pipes, devices and files without
+/// a known size, like the ones in @c /proc, are read with @c read() into a
+/// buffer of @c bufferSize bytes.
+/// @code
+/// auto reader = FileReader{path};
+/// for (auto chunk = reader.next(); !chunk.empty(); chunk = reader.next()) {
+///   consume(chunk);
+/// }
+/// @endcode
+/// Alternatively @c read fills buffers of the caller, e.g. from a
+/// @c BufferPool. Both ways of reading continue where the other stopped.
+class FileReader {
+public:
+  static constexpr usize defaultBufferSize = usize{1U} << 20U;
+
+  /// Opens the file at @c path for reading.
+  /// @throws system_error if the file can not be opened.
+  explicit FileReader(const filesystem::path &path,
+                      usize bufferSize = defaultBufferSize)
+      PRE(bufferSize > 0U)
+      : _file{path}, _path{path}, _bufferSize{bufferSize} {
+    const auto status = _file.status(path);
+    _isRegular        = S_ISREG(status.st_mode) && status.st_size > 0;
+    _mapPending       = _isRegular;
+    _size             = _isRegular ? static_cast<usize>(status.st_size) : 0U;
+  }
+
+  /// Returns the next chunk of the file, that is valid until the next call,
+  /// or an empty span at the end of the file.
+  /// @throws system_error if reading fails.
+  [[nodiscard]] span<const byte> next() {
+    _mapOnce();
+    if (_isMapped) {
+      return _mapped.bytes().subspan(exchange(_position, _mapped.size()));
+    }
+    _buffer.resize(_bufferSize);
+    return span{_buffer}.first(read(_buffer));
+  }
+
+  /// Copies the next bytes of the file into @c buffer.
+  /// Regular files are read with @c pread() instead of mapping them, which
+  /// avoids a page fault for every page.
+  /// @returns the number of bytes, which is zero at the end of the file.
+  /// Pipes may return less than the size of @c buffer before their end.
+  /// @throws system_error if reading fails.
+  [[nodiscard]] usize read(span<byte> buffer) {
+    while (true) {
+      const auto count =
+          _isRegular ? ::pread(_file.get(), buffer.data(), buffer.size(),
+                               static_cast<off_t>(_position))
+                     : ::read(_file.get(), buffer.data(), buffer.size());
+      if (count >= 0) {
+        _position += static_cast<usize>(count);
+        return static_cast<usize>(count);
+      }
+      if (errno != EINTR) {
+        throw system_error{errno, generic_category(),
+                           "Can not read '" + _path.string() + "'"};
+      }
+    }
+  }
+
+private:
+  /// Map a regular file once, if it is read with @c next.
+  void _mapOnce() {
+    if (!_mapPending) {
+      return;
+    }
+    _mapPending = false;
+    try {
+      _mapped._map(_file, _size, FileAccess::Sequential, _path);
+      _isMapped = true;
+    } catch (const system_error &) {
+      // Some file systems do not support mapping, read them instead.
+    }
+  }
+
+  FileDescriptor _file;
+  filesystem::path _path;
+  usize _bufferSize;
+  /// Regular files with a known size are read at @c _position.
+  bool _isRegular{false};
+  usize _size{0U};
+  bool _mapPending{false};
+  MappedFile _mapped;
+  bool _isMapped{false};
+  usize _position{0U};
+  vector<byte> _buffer;
+};
+
+} // namespace jt
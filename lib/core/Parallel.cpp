@@ -0,0 +1,161 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Core:Parallel;
+
+import :Types;
+
+import std;
+
+using namespace std;
+
+export namespace jt {
+
+/// Returns the number of concurrent threads the hardware supports, but at
+/// least one.
+inline usize hardwareThreads() noexcept {
+  return max(usize{1U}, usize{thread::hardware_concurrency()});
+}
+
+/// Calls @c f(i) for every @c i in @c [0, count) on up to @c threads threads,
+/// including the calling thread. Indices are handed out one at a time, so
+/// unevenly expensive work items balance themselves.
+/// If @c f throws, no further indices are started and the first exception is
+/// rethrown once all threads finished.
+template <invocable<usize> F>
+void parallelFor(usize count, usize threads, F &&f) {
+  threads = min(threads, count);
+  if (threads <= 1U) {
+    for (usize i = 0U; i < count; ++i) {
+      f(i);
+    }
+    return;
+  }
+
+  atomic<usize> next{0U};
+  mutex errorMutex;
+  exception_ptr firstError;
+  const auto worker = [&]() {
+    for (usize i = next.fetch_add(1U, memory_order_relaxed); i < count;
+         i       = next.fetch_add(1U, memory_order_relaxed)) {
+      try {
+        f(i);
+      } catch (...) {
+        const auto lock = lock_guard{errorMutex};
+        if (!firstError) {
+          firstError = current_exception();
+        }
+        next.store(count, memory_order_relaxed);
+        return;
+      }
+    }
+  };
+
+  {
+    auto workers = vector<jthread>{};
+    workers.reserve(threads - 1U);
+    for (usize t = 1U; t < threads; ++t) {
+      workers.emplace_back(worker);
+    }
+    worker();
+  }
+
+  if (firstError) {
+    rethrow_exception(firstError);
+  }
+}
+
+/// Queue with a fixed capacity, that connects producer and consumer threads.
+/// @c push blocks while the queue is full and @c pop blocks while it is
+/// empty, so a fast producer can not run ahead of its consumers and the
+/// memory stays bounded.
+/// After @c close, no items are accepted anymore, but the remaining ones are
+/// still handed out.
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(usize capacity) PRE(capacity > 0U)
+      : _capacity{capacity} {}
+
+  /// Appends @c item, waiting until there is room.
+  /// @returns @c false if the queue is closed and the item was dropped.
+  bool push(T item) {
+    auto lock = unique_lock{_mutex};
+    _notFull.wait(lock,
+                  [this] { return _closed || _items.size() < _capacity; });
+    if (_closed) {
+      return false;
+    }
+    _items.push_back(move(item));
+    lock.unlock();
+    _notEmpty.notify_one();
+    return true;
+  }
+
+  /// Removes the oldest item, waiting until there is one.
+  /// @returns @c nullopt if the queue is closed and empty.
+  optional<T> pop() {
+    auto lock = unique_lock{_mutex};
+    _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+    if (_items.empty()) {
+      return nullopt;
+    }
+    auto item = move(_items.front());
+    _items.pop_front();
+    lock.unlock();
+    _notFull.notify_one();
+    return item;
+  }
+
+  /// Wakes up all waiting threads and rejects further items.
+  void close() {
+    {
+      const auto lock = lock_guard{_mutex};
+      _closed         = true;
+    }
+    _notFull.notify_all();
+    _notEmpty.notify_all();
+  }
+
+  [[nodiscard]] usize capacity() const noexcept { return _capacity; }
+
+private:
+  mutex _mutex;
+  condition_variable _notFull;
+  condition_variable _notEmpty;
+  deque<T> _items;
+  usize _capacity;
+  bool _closed{false};
+};
+
+/// Fixed number of equally sized buffers, that are handed out and returned
+/// again. Threads that need a buffer wait until another one is released,
+/// which bounds the memory of a pipeline independent of its input.
+class BufferPool {
+public:
+  BufferPool(usize count, usize bufferSize)
+      PRE(count > 0U && bufferSize > 0U)
+      : _storage(count * bufferSize), _free{count}, _bufferSize{bufferSize} {
+    for (usize i = 0U; i < count; ++i) {
+      _free.push(span{_storage}.subspan(i * bufferSize, bufferSize));
+    }
+  }
+
+  /// Returns a free buffer, waiting until there is one.
+  [[nodiscard]] span<byte> acquire() { return *_free.pop(); }
+
+  /// Returns @c buffer, that was acquired from this pool, to the pool.
+  void release(span<byte> buffer) PRE(buffer.size() == _bufferSize) {
+    _free.push(buffer);
+  }
+
+  [[nodiscard]] usize count() const noexcept { return _free.capacity(); }
+  [[nodiscard]] usize bufferSize() const noexcept { return _bufferSize; }
+
+private:
+  vector<byte> _storage;
+  BoundedQueue<span<byte>> _free;
+  usize _bufferSize;
+};
+
+} // namespace jt
@@ -7,20 +7,31 @@ export namespace jt::crypto {
 
 template <typename T>
 concept ByteSizedValueType = requires() {
-  { sizeof(typename ranges::range_value_t<T>) == 1 };
+  requires(sizeof(ranges::range_value_t<T>) == 1);
 };
 template <typename T>
 concept ByteSizedIterator = requires() {
-  { sizeof(typename T::value_type) == 1 };
+  requires(sizeof(typename T::value_type) == 1);
 };
 template <typename T>
 concept CryptHashable = ranges::input_range<T> && ByteSizedValueType<T>;
 
+/// A digest, e.g. formatted as @c string or as bytes in an @c array.
 template <typename T>
-concept HashFunctor = requires(T t) {
-  { t.process("Hello World") } -> same_as<void>;
-  { t.digest() } -> same_as<string>;
+concept HashDigest = ranges::contiguous_range<T> && ranges::sized_range<T> &&
+                     (sizeof(ranges::range_value_t<T>) == 1);
+
+template <typename T>
+concept HashFunctor = requires(T t, string_view message) {
+  { t.process(message) } -> same_as<void>;
+  { t.digest() } -> HashDigest;
   { t.reset() } -> same_as<void>;
 };
 
+/// Hash functors, that return the digest as bytes without formatting it.
+template <typename T>
+concept BinaryHashFunctor = HashFunctor<T> && requires(T t) {
+  { t.digest_bytes() } -> HashDigest;
+};
+
 } // namespace jt::crypto
@@ -5,5 +5,7 @@ export import jt.Math;
 
 export import :Concepts;
 export import :Sha256;
+export import :Sha256MultiBuffer;
+export import :Sha256Tree;
 export import :TextbookRSA;
 
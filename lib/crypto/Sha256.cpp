@@ -2,6 +2,10 @@ module;
 
 #include "jt-computing/core/Contracts.hpp"
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 export module jt.Crypto:Sha256;
 
 import :Concepts;
@@ -11,57 +15,268 @@ import std;
 
 using namespace std;
 
-namespace {
-using namespace jt;
+export namespace jt::crypto {
+
+/// Compression function of SHA-256, that hashes a sequence of 64 byte blocks
+/// into the state.
+using Sha256Compression = void(array<u32, 8> &, span<const u8>);
+
+} // namespace jt::crypto
 
-string str(const array<u32, 8> &digest) {
-  stringstream s;
-  s << setfill('0') << hex;
-  auto bytes = as_bytes(span{digest});
-  for (auto b : bytes) {
-    // Note: Cast to @c uint is necessary, because @c u8 turns into a char and
-    // not a hex-number.
-    s << setw(2) << to_integer<uint>(b);
+namespace jt::crypto {
+
+/// Constants defined in Section 4.2.3.
+alignas(64) constexpr array<u32, 64> roundConstants = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+/// Initial hash value defined in Section 5.3.3.
+constexpr array<u32, 8> initialState{
+    /*A=*/0x6a09e667, /*B=*/0xbb67ae85, /*C=*/0x3c6ef372, /*D=*/0xa54ff53a,
+    /*E=*/0x510e527f, /*F=*/0x9b05688c, /*G=*/0x1f83d9ab, /*H=*/0x5be0cd19};
+
+/// Two lower case hex digits for every value of a byte.
+constexpr auto hexDigits = [] {
+  constexpr auto digits = string_view{"0123456789abcdef"};
+  auto table            = array<array<char, 2>, 256>{};
+  for (usize b = 0U; b < table.size(); ++b) {
+    table[b] = {digits[b >> 4U], digits[b & 0xFU]};
   }
+  return table;
+}();
+
+/// Format @c bytes as hex string with two lower case digits per byte.
+constexpr string hexString(span<const byte> bytes) {
+  auto result = string(2U * bytes.size(), '\0');
+  for (usize i = 0U; i < bytes.size(); ++i) {
+    const auto &digits  = hexDigits[to_integer<u8>(bytes[i])];
+    result[2U * i]      = digits[0];
+    result[2U * i + 1U] = digits[1];
+  }
+  return result;
+}
+
+/// Return the big-endian bytes of the hash value @c state.
+constexpr array<byte, 32> digestBytes(const array<u32, 8> &state) {
+  auto result = array<byte, 32>{};
+  for (usize i = 0U; i < state.size(); ++i) {
+    for (usize k = 0U; k < 4U; ++k) {
+      result[4U * i + k] = static_cast<byte>(state[i] >> (24U - 8U * k));
+    }
+  }
+  return result;
+}
 
-  return s.str();
+/// Format the hash value @c state as hex string of its big-endian bytes.
+string hexDigest(const array<u32, 8> &state) {
+  return hexString(digestBytes(state));
 }
 
 /// Defined in Section 4.1.2, (4.2).
-u32 Ch(u32 x, u32 y, u32 z) { return (x & y) ^ (~x & z); }
+constexpr u32 Ch(u32 x, u32 y, u32 z) { return (x & y) ^ (~x & z); }
 /// Defined in Section 4.1.2, (4.3).
-u32 Maj(u32 x, u32 y, u32 z) { return (x & y) ^ (x & z) ^ (y & z); }
+constexpr u32 Maj(u32 x, u32 y, u32 z) { return (x & y) ^ (x & z) ^ (y & z); }
 /// Defined in Section 4.1.2, (4.4).
-u32 Sum0(u32 x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
+constexpr u32 Sum0(u32 x) { return rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22); }
 /// Defined in Section 4.1.2, (4.5).
-u32 Sum1(u32 x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
+constexpr u32 Sum1(u32 x) { return rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25); }
 /// Defined in Section 4.1.2, (4.6).
-u32 Sig0(u32 x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3U); }
+constexpr u32 Sig0(u32 x) { return rotr(x, 7) ^ rotr(x, 18) ^ (x >> 3U); }
 /// Defined in Section 4.1.2, (4.7).
-u32 Sig1(u32 x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10U); }
+constexpr u32 Sig1(u32 x) { return rotr(x, 17) ^ rotr(x, 19) ^ (x >> 10U); }
+
+/// Portable implementation of the compression function, that hashes every
+/// 64 byte block of @c blocks into @c state.
+constexpr void compressPortable(array<u32, 8> &state, span<const u8> blocks) {
+  for (usize offset = 0U; offset < blocks.size(); offset += 64U) {
+    const auto block = blocks.subspan(offset, 64U);
+    alignas(64) array<u32, 64> W;
+
+    // Section 6.2.2, Step 1. (1)
+    // Insert all data of this block at the start of the message schedule in
+    // big-endian words.
+    for (usize t = 0U; t < 16U; ++t) {
+      W[t] = (u32{block[4U * t]} << 24U) | (u32{block[4U * t + 1U]} << 16U) |
+             (u32{block[4U * t + 2U]} << 8U) | u32{block[4U * t + 3U]};
+    }
+
+    // Section 6.2.2, Step 1. (2).
+    // The rest of the message schedule is derived from the previous data
+    // words.
+    for (usize t = 16U; t < 64U; ++t) {
+      W[t] = Sig1(W[t - 2]) + W[t - 7] + Sig0(W[t - 15]) + W[t - 16];
+    }
+
+    // Section 6.2.2, Step 2.
+    alignas(64) array<u32, 8> abcdefgh = state;
+    auto &[a, b, c, d, e, f, g, h]     = abcdefgh;
+
+    // Section 6.2.2, Step 3.
+    for (usize t = 0U; t < 64U; ++t) {
+      // clang-format off
+      u32 T1 = h
+             + Sum1(e)
+             + Ch(e, f, g)
+             + roundConstants[t]
+             + W[t];
+      u32 T2 = Sum0(a) + Maj(a, b, c);
+      // clang-format on
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + T1;
+      d = c;
+      c = b;
+      b = a;
+      a = T1 + T2;
+    }
+
+    for (usize i = 0U; i < 8U; i++) {
+      state[i] += abcdefgh[i];
+    }
+  }
+}
+
+} // namespace jt::crypto
+
+namespace {
+using namespace jt;
+using crypto::roundConstants;
+
+#if defined(__x86_64__)
+/// Implementation of the compression function with the SHA extensions.
+/// @c sha256rnds2 performs two rounds on the state, that is split into the
+/// registers ABEF and CDGH. @c sha256msg1 and @c sha256msg2 derive the next
+/// four words of the message schedule, which is kept in four registers.
+[[gnu::target("sha,sse4.1,ssse3")]] void
+compressShaNi(array<u32, 8> &state, span<const u8> blocks) {
+  // Reverses the bytes of each word to load them big-endian.
+  const __m128i byteOrder =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+  const auto load = [](const void *address) {
+    return _mm_loadu_si128(static_cast<const __m128i *>(address));
+  };
+
+  // Rearrange the state from ABCD EFGH to ABEF CDGH.
+  __m128i tmp   = _mm_shuffle_epi32(load(&state[0]), 0xB1);
+  __m128i cdgh  = _mm_shuffle_epi32(load(&state[4]), 0x1B);
+  __m128i abef  = _mm_alignr_epi8(tmp, cdgh, 8);
+  cdgh          = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+  for (usize offset = 0U; offset < blocks.size(); offset += 64U) {
+    const __m128i abefSave = abef;
+    const __m128i cdghSave = cdgh;
+
+    __m128i message[4];
+    for (usize i = 0U; i < 4U; ++i) {
+      message[i] = _mm_shuffle_epi8(load(&blocks[offset + 16U * i]), byteOrder);
+    }
+
+    // Each step performs four rounds. The message words for the steps 4 to 15
+    // are computed in place of the ones of four steps before.
+#pragma GCC unroll 16
+    for (usize step = 0U; step < 16U; ++step) {
+      __m128i &current  = message[step % 4U];
+      __m128i &next     = message[(step + 1U) % 4U];
+      __m128i &previous = message[(step + 3U) % 4U];
+
+      __m128i words = _mm_add_epi32(current, load(&roundConstants[4U * step]));
+      cdgh          = _mm_sha256rnds2_epu32(cdgh, abef, words);
+      if (step >= 3U && step < 15U) {
+        tmp  = _mm_alignr_epi8(current, previous, 4);
+        next = _mm_sha256msg2_epu32(_mm_add_epi32(next, tmp), current);
+      }
+      words = _mm_shuffle_epi32(words, 0x0E);
+      abef  = _mm_sha256rnds2_epu32(abef, cdgh, words);
+      if (step >= 1U && step < 13U) {
+        previous = _mm_sha256msg1_epu32(previous, current);
+      }
+    }
+
+    abef = _mm_add_epi32(abef, abefSave);
+    cdgh = _mm_add_epi32(cdgh, cdghSave);
+  }
+
+  // Rearrange the state back to ABCD EFGH.
+  tmp  = _mm_shuffle_epi32(abef, 0x1B);
+  cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[0]),
+                   _mm_blend_epi16(tmp, cdgh, 0xF0));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[4]),
+                   _mm_alignr_epi8(cdgh, tmp, 8));
+}
+#endif
+
+constexpr auto compressionImplementationList = array{
+#if defined(__x86_64__)
+    Implementation<crypto::Sha256Compression>{
+        "sha",
+        {CpuFeature::SHA, CpuFeature::SSE41, CpuFeature::SSSE3},
+        &compressShaNi},
+#endif
+    Implementation<crypto::Sha256Compression>{
+        "portable", {}, &crypto::compressPortable},
+};
 
 } // namespace
 
+namespace jt::crypto {
+
+/// Return the best compression function for the host, which is selected once.
+Sha256Compression *bestCompression() {
+  static Sha256Compression *const function =
+      selectImplementation(span{compressionImplementationList}).function;
+  return function;
+}
+
+} // namespace jt::crypto
+
 export namespace jt::crypto {
 
+/// Return the implementations of the compression function from the best to
+/// the portable one, e.g. to test all of them that the host supports.
+span<const Implementation<Sha256Compression>> sha256Implementations() {
+  return compressionImplementationList;
+}
+
 // Implements Sha256 as described in FIPS PUB 180-4.
+// The compression function uses the SHA extensions if the processor
+// supports them.
+// Hashing is possible in constant expressions as well, which use the
+// portable compression function, e.g. to embed digests of literals:
+// @code
+// constexpr auto digest = [] {
+//   auto s = Sha256Sum{};
+//   s.process("abc"sv);
+//   return s.digest_bytes();
+// }();
+// @endcode
 class Sha256Sum {
 public:
-  void process(CryptHashable auto const &data);
+  constexpr void process(CryptHashable auto const &data);
 
   void process(char const *str) = delete;
-  void process(string_view str) {
-    auto s = span{str};
-    auto b = as_bytes(s);
-    return process(b);
-  }
+  constexpr void process(string_view str) { return process(span{str}); }
 
-  template <input_iterator I> void process(I begin, I end) {
+  template <input_iterator I> constexpr void process(I begin, I end) {
     return process(ranges::subrange{begin, end});
   }
 
-  string digest() POST(r : r.size() == 64);
-  void reset();
+  /// Returns the digest as hex string with two lower case digits per byte.
+  constexpr string digest() POST(r : r.size() == 64);
+  /// Returns the digest as bytes, which avoids formatting it.
+  constexpr array<byte, 32> digest_bytes();
+  constexpr void reset();
 
 private:
   static constexpr usize blockSize = 64;
@@ -69,44 +284,39 @@ private:
   alignas(cacheLine) array<u8, blockSize> _data{0};
 
   /// Defined in Section 5.3.3.
-  alignas(cacheLine) array<u32, 8> H{
-      /*A=*/0x6a09e667, /*B=*/0xbb67ae85, /*C=*/0x3c6ef372,
-      /*D=*/0xa54ff53a, /*E=*/0x510e527f, /*F=*/0x9b05688c,
-      /*G=*/0x1f83d9ab, /*H=*/0x5be0cd19};
-
-  // Constants defined in Section 4.2.3.
-  alignas(cacheLine) static constexpr array<u32, blockSize> K = {
-      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
-      0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-      0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
-      0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
-      0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-      0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
-      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
-      0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-      0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+  alignas(cacheLine) array<u32, 8> H = initialState;
 
   u64 _blockLength{0};
   u64 _bitLen{0};
-  string _digest;
+  optional<array<byte, 32>> _digest;
 
-  void transform();
-  void pad();
+  /// Hash the full blocks of @c blocks into the state.
+  constexpr void transform(span<const u8> blocks);
+  void processContiguous(span<const byte> bytes);
+  constexpr void pad();
 };
 
-void Sha256Sum::process(CryptHashable auto const &data) {
-  if (!_digest.empty()) {
+constexpr void Sha256Sum::process(CryptHashable auto const &data) {
+  if (_digest) {
     throw runtime_error{"Digest Computed, Can not further update Message"};
   }
+  using Range = decltype(data);
+  // Viewing the input as bytes is not possible in constant expressions.
+  if !consteval {
+    if constexpr (ranges::contiguous_range<Range> &&
+                  ranges::sized_range<Range>) {
+      processContiguous(
+          as_bytes(span{ranges::data(data), ranges::size(data)}));
+      return;
+    }
+  }
   for (auto b : data) {
-    _data[_blockLength++] = bit_cast<u8>(b);
+    _data[_blockLength++] = static_cast<u8>(b);
 
     // Once a datablock is full, apply the "compression function" that actually
     // hashes.
     if (_blockLength == blockSize) {
-      transform();
+      transform(_data);
 
       // End of the block
       _bitLen += blockSize * BitsPerByte;
@@ -115,95 +325,65 @@ void Sha256Sum::process(CryptHashable auto const &data) {
   }
 }
 
-string Sha256Sum::digest() {
-  if (_digest.empty()) {
+constexpr string Sha256Sum::digest() { return hexString(digest_bytes()); }
+constexpr array<byte, 32> Sha256Sum::digest_bytes() {
+  if (!_digest) {
     pad();
 
-    auto hashDigest = array<u32, 8>{0};
-    if constexpr (endian::native == endian::little) {
-      std::transform(H.begin(), H.end(), hashDigest.begin(),
-                     [](u32 state) { return byteswap(state); });
-    } else {
-      copy(H.begin(), H.end(), hashDigest.begin());
-    }
-    auto digestString = str(hashDigest);
-    _digest           = digestString;
+    _digest = digestBytes(H);
   }
 
-  return _digest;
+  return *_digest;
 }
-void Sha256Sum::reset() {
+constexpr void Sha256Sum::reset() {
   // Defined in 5.3.3.
   //
   // Initialize the state to the constants.
-  // clang-format off
-  H = {/*A=*/0x6a09e667, /*B=*/0xbb67ae85,
-       /*C=*/0x3c6ef372, /*D=*/0xa54ff53a,
-       /*E=*/0x510e527f, /*F=*/0x9b05688c,
-       /*G=*/0x1f83d9ab, /*H=*/0x5be0cd19};
-  // clang-format on
+  H = initialState;
 
   // Reset the internal values that are used to pad and process the data.
   _data        = array<u8, blockSize>{0};
   _blockLength = 0;
   _bitLen      = 0;
-  _digest.clear();
+  _digest.reset();
 }
 
-void Sha256Sum::transform() {
-  alignas(cacheLine) array<u32, blockSize> W;
-
-  // Section 6.2.2, Step 1. (1)
-  // Insert all data of this block at the start of the message schedule in
-  // big-endian words.
-
-  auto reinterpretedData =
-      span<u32>{reinterpret_cast<u32 *>(_data.data()), blockSize / sizeof(u32)};
-
-  if constexpr (endian::native == endian::little) {
-    std::transform(reinterpretedData.begin(), reinterpretedData.end(),
-                   W.begin(), [](u32 state) { return byteswap(state); });
+constexpr void Sha256Sum::transform(span<const u8> blocks) {
+  if consteval {
+    compressPortable(H, blocks);
   } else {
-    copy(reinterpretedData.begin(), reinterpretedData.end(), W.begin());
+    bestCompression()(H, blocks);
   }
+}
 
-  // Section 6.2.2, Step 1. (2).
-  // The rest of the message schedule is derived from the previous data words.
-  for (u8 t = 16; t < blockSize; ++t) {
-    W[t] = Sig1(W[t - 2]) + W[t - 7] + Sig0(W[t - 15]) + W[t - 16];
-  }
+void Sha256Sum::processContiguous(span<const byte> bytes) {
+  auto input = span{reinterpret_cast<const u8 *>(bytes.data()), bytes.size()};
 
-  // Section 6.2.2, Step 2.
-  alignas(cacheLine) array<u32, 8> abcdefgh = H;
-  auto &[a, b, c, d, e, f, g, h]            = abcdefgh;
-
-  // Section 6.2.2, Step 3.
-  for (u8 t = 0; t < blockSize; ++t) {
-    // clang-format off
-    u32 T1 = h
-           + Sum1(e)
-           + Ch(e, f, g)
-           + K[t]
-           + W[t];
-    u32 T2 = Sum0(a) + Maj(a, b, c);
-    // clang-format on
-
-    h = g;
-    g = f;
-    f = e;
-    e = d + T1;
-    d = c;
-    c = b;
-    b = a;
-    a = T1 + T2;
+  // Complete the block, that was started by a previous call.
+  if (_blockLength > 0) {
+    const auto count = min<usize>(input.size(), blockSize - _blockLength);
+    ranges::copy(input.first(count), _data.begin() + _blockLength);
+    _blockLength += count;
+    if (_blockLength < blockSize) {
+      return;
+    }
+    input        = input.subspan(count);
+    _blockLength = 0;
+    transform(_data);
+    _bitLen += blockSize * BitsPerByte;
   }
 
-  for (u8 i = 0; i < 8; i++) {
-    H[i] += abcdefgh[i];
+  // Hash all full blocks directly from the input and buffer only the rest.
+  const usize full = input.size() - input.size() % blockSize;
+  if (full > 0) {
+    transform(input.first(full));
+    _bitLen += full * BitsPerByte;
   }
+  ranges::copy(input.subspan(full), _data.begin());
+  _blockLength = input.size() - full;
 }
 
-void Sha256Sum::pad() {
+constexpr void Sha256Sum::pad() {
   // Defined in Section 5.1.1.
   //
   // Insert the padding appropriately.
@@ -220,7 +400,7 @@ void Sha256Sum::pad() {
   }
 
   if (_blockLength >= 56) {
-    this->transform();
+    this->transform(_data);
     fill_n(_data.begin(), 56, 0U);
   }
 
@@ -234,6 +414,6 @@ void Sha256Sum::pad() {
   _data[58] = static_cast<u8>(_bitLen >> 40U);
   _data[57] = static_cast<u8>(_bitLen >> 48U);
   _data[56] = static_cast<u8>(_bitLen >> 56U);
-  transform();
+  transform(_data);
 }
 } // namespace jt::crypto
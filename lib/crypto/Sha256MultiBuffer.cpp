@@ -0,0 +1,339 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Crypto:Sha256MultiBuffer;
+
+import :Sha256;
+
+import jt.Core;
+import std;
+
+using namespace std;
+
+export namespace jt::crypto {
+
+/// Hashes every message of the first argument into the hash value with the
+/// same index of the second argument.
+using Sha256BatchFunction = void(span<const string_view>, span<array<u32, 8>>);
+
+} // namespace jt::crypto
+
+namespace {
+using namespace jt;
+using crypto::initialState;
+using crypto::roundConstants;
+
+typedef u32 u32x8 __attribute__((vector_size(32)));
+typedef u32 u32x16 __attribute__((vector_size(64)));
+
+template <typename Vector>
+constexpr usize laneCount = sizeof(Vector) / sizeof(u32);
+
+/// Read the big-endian word at @c bytes.
+u32 loadBigEndian(const u8 *bytes) {
+  return (u32{bytes[0]} << 24U) | (u32{bytes[1]} << 16U) |
+         (u32{bytes[2]} << 8U) | u32{bytes[3]};
+}
+
+// Returning a vector from a function, that does not enable the instruction
+// set of the vector width, changes the ABI. GCC warns about it even for
+// functions that are always inlined, so the functions below add their result
+// to their first argument instead of returning it.
+
+/// The functions of Section 4.1.2 for each lane of a vector, that add their
+/// result to @c sum.
+template <typename Vector>
+[[gnu::always_inline]] inline void addCh(Vector &sum, Vector x, Vector y,
+                                         Vector z) {
+  sum += (x & y) ^ (~x & z);
+}
+template <typename Vector>
+[[gnu::always_inline]] inline void addMaj(Vector &sum, Vector x, Vector y,
+                                          Vector z) {
+  sum += (x & y) ^ (x & z) ^ (y & z);
+}
+template <typename Vector>
+[[gnu::always_inline]] inline void addSum0(Vector &sum, Vector x) {
+  sum += ((x >> 2U) | (x << 30U)) ^ ((x >> 13U) | (x << 19U)) ^
+         ((x >> 22U) | (x << 10U));
+}
+template <typename Vector>
+[[gnu::always_inline]] inline void addSum1(Vector &sum, Vector x) {
+  sum += ((x >> 6U) | (x << 26U)) ^ ((x >> 11U) | (x << 21U)) ^
+         ((x >> 25U) | (x << 7U));
+}
+template <typename Vector>
+[[gnu::always_inline]] inline void addSig0(Vector &sum, Vector x) {
+  sum += ((x >> 7U) | (x << 25U)) ^ ((x >> 18U) | (x << 14U)) ^ (x >> 3U);
+}
+template <typename Vector>
+[[gnu::always_inline]] inline void addSig1(Vector &sum, Vector x) {
+  sum += ((x >> 17U) | (x << 15U)) ^ ((x >> 19U) | (x << 13U)) ^ (x >> 10U);
+}
+
+/// Hash one block per lane into the transposed state, in which
+/// @c state[i][lane] is the word @c i of the hash value of @c lane.
+/// The kernel is inlined into functions that enable the instruction set of
+/// the vector width.
+template <typename Vector>
+[[gnu::always_inline]] inline void
+compressLanes(array<Vector, 8> &state,
+              const array<const u8 *, laneCount<Vector>> &blocks) {
+  // Section 6.2.2, Step 1. The message schedule is kept as ring of the last
+  // 16 words.
+  array<Vector, 16> W;
+  for (usize t = 0U; t < 16U; ++t) {
+    for (usize lane = 0U; lane < laneCount<Vector>; ++lane) {
+      W[t][lane] = loadBigEndian(blocks[lane] + 4U * t);
+    }
+  }
+
+  // Section 6.2.2, Step 2.
+  auto [a, b, c, d, e, f, g, h] = state;
+
+  // Section 6.2.2, Step 3.
+  for (usize t = 0U; t < 64U; ++t) {
+    if (t >= 16U) {
+      // The slot of the ring still holds the word of 16 rounds before.
+      Vector word = W[t % 16U] + W[(t - 7U) % 16U];
+      addSig0(word, W[(t - 15U) % 16U]);
+      addSig1(word, W[(t - 2U) % 16U]);
+      W[t % 16U] = word;
+    }
+    Vector T1 = h + roundConstants[t] + W[t % 16U];
+    addSum1(T1, e);
+    addCh(T1, e, f, g);
+    Vector T2{};
+    addSum0(T2, a);
+    addMaj(T2, a, b, c);
+
+    h = g;
+    g = f;
+    f = e;
+    e = d + T1;
+    d = c;
+    c = b;
+    b = a;
+    a = T1 + T2;
+  }
+
+  // Section 6.2.2, Step 4.
+  const auto abcdefgh = array<Vector, 8>{a, b, c, d, e, f, g, h};
+  for (usize i = 0U; i < 8U; ++i) {
+    state[i] += abcdefgh[i];
+  }
+}
+
+/// Message of one lane, that is hashed block by block.
+/// The full blocks are read from the message directly, the remaining bytes
+/// and the padding of Section 5.1.1 from @c tail.
+struct Lane {
+  usize message{0U};
+  usize block{0U};
+  usize fullBlocks{0U};
+  usize blocks{0U};
+  alignas(64) array<u8, 128> tail{};
+
+  [[nodiscard]] bool active() const noexcept { return block < blocks; }
+
+  void assign(usize index, string_view bytes) {
+    message    = index;
+    block      = 0U;
+    fullBlocks = bytes.size() / 64U;
+
+    const auto rest      = bytes.substr(fullBlocks * 64U);
+    const usize tailSize = rest.size() + 9U <= 64U ? 64U : 128U;
+    blocks               = fullBlocks + tailSize / 64U;
+
+    ranges::fill(tail, u8{0U});
+    ranges::transform(rest, tail.begin(),
+                      [](char byte) { return bit_cast<u8>(byte); });
+    tail[rest.size()]   = 0x80U;
+    const u64 bitLength = u64{bytes.size()} * BitsPerByte;
+    for (usize i = 0U; i < 8U; ++i) {
+      tail[tailSize - 1U - i] = static_cast<u8>(bitLength >> (8U * i));
+    }
+  }
+
+  /// Return the @c count next blocks, which are either all in the message or
+  /// all in the tail.
+  [[nodiscard]] span<const u8> nextBlocks(string_view bytes,
+                                          usize count) const noexcept {
+    if (block < fullBlocks) {
+      const auto *data = reinterpret_cast<const u8 *>(bytes.data());
+      return {data + block * 64U, min(count, fullBlocks - block) * 64U};
+    }
+    return span{tail}.subspan((block - fullBlocks) * 64U,
+                              min(count, blocks - block) * 64U);
+  }
+};
+
+/// Hash @c message with the best single buffer compression function.
+void hashSingle(string_view message, array<u32, 8> &state) {
+  static auto *const compress =
+      selectImplementation(crypto::sha256Implementations()).function;
+  auto lane = Lane{};
+  lane.assign(0U, message);
+  while (lane.active()) {
+    const auto blocks = lane.nextBlocks(message, lane.blocks);
+    compress(state, blocks);
+    lane.block += blocks.size() / 64U;
+  }
+}
+
+/// Hash the messages with one message per lane of @c Vector. A lane that
+/// finished its message continues with the next one, so the lanes stay busy
+/// for messages of different length. Once no message is left and less than
+/// half of the lanes are busy, the remaining blocks are hashed one message at
+/// a time.
+template <typename Vector>
+void hashLanes(span<const string_view> messages, span<array<u32, 8>> states,
+               void (*compress)(array<Vector, 8> &,
+                                const array<const u8 *, laneCount<Vector>> &)) {
+  constexpr usize lanes = laneCount<Vector>;
+  alignas(64) static constexpr array<u8, 64> idleBlock{};
+
+  auto state  = array<Vector, 8>{};
+  auto lane   = array<Lane, lanes>{};
+  auto blocks = array<const u8 *, lanes>{};
+  usize next  = 0U;
+
+  const auto start = [&](usize l) {
+    if (next == messages.size()) {
+      return;
+    }
+    lane[l].assign(next, messages[next]);
+    for (usize i = 0U; i < 8U; ++i) {
+      state[i][l] = initialState[i];
+    }
+    ++next;
+  };
+  const auto finish = [&](usize l) {
+    auto &result = states[lane[l].message];
+    for (usize i = 0U; i < 8U; ++i) {
+      result[i] = state[i][l];
+    }
+  };
+
+  for (usize l = 0U; l < lanes; ++l) {
+    start(l);
+  }
+  while (true) {
+    const auto busy = ranges::count_if(lane, &Lane::active);
+    const bool fewLeft =
+        next == messages.size() && 2U * static_cast<usize>(busy) < lanes;
+    if (busy == 0 || fewLeft) {
+      break;
+    }
+    for (usize l = 0U; l < lanes; ++l) {
+      blocks[l] = lane[l].active()
+                      ? lane[l].nextBlocks(messages[lane[l].message], 1U).data()
+                      : idleBlock.data();
+    }
+    compress(state, blocks);
+    for (usize l = 0U; l < lanes; ++l) {
+      if (lane[l].active() && ++lane[l].block == lane[l].blocks) {
+        finish(l);
+        start(l);
+      }
+    }
+  }
+
+  // Hash the rest of the few remaining messages one at a time.
+  auto *const single =
+      selectImplementation(crypto::sha256Implementations()).function;
+  for (usize l = 0U; l < lanes; ++l) {
+    if (!lane[l].active()) {
+      continue;
+    }
+    finish(l);
+    const auto &message = messages[lane[l].message];
+    while (lane[l].active()) {
+      const auto rest = lane[l].nextBlocks(message, lane[l].blocks);
+      single(states[lane[l].message], rest);
+      lane[l].block += rest.size() / 64U;
+    }
+  }
+}
+
+#if defined(__x86_64__)
+[[gnu::target("avx2")]] void
+compressAvx2(array<u32x8, 8> &state, const array<const u8 *, 8> &blocks) {
+  compressLanes(state, blocks);
+}
+void hashAvx2(span<const string_view> messages, span<array<u32, 8>> states) {
+  hashLanes<u32x8>(messages, states, &compressAvx2);
+}
+
+[[gnu::target("avx512f")]] void
+compressAvx512(array<u32x16, 8> &state, const array<const u8 *, 16> &blocks) {
+  compressLanes(state, blocks);
+}
+void hashAvx512(span<const string_view> messages,
+                span<array<u32, 8>> states) {
+  hashLanes<u32x16>(messages, states, &compressAvx512);
+}
+#endif
+
+/// Hash one message after another.
+void hashSequential(span<const string_view> messages,
+                    span<array<u32, 8>> states) {
+  for (usize i = 0U; i < messages.size(); ++i) {
+    states[i] = initialState;
+    hashSingle(messages[i], states[i]);
+  }
+}
+
+constexpr auto batchImplementationList = array{
+#if defined(__x86_64__)
+    Implementation<crypto::Sha256BatchFunction>{
+        "avx512f", {CpuFeature::AVX512F}, &hashAvx512},
+    // One message at a time with the SHA extensions is faster than eight
+    // lanes of AVX2.
+    Implementation<crypto::Sha256BatchFunction>{
+        "sha",
+        {CpuFeature::SHA, CpuFeature::SSE41, CpuFeature::SSSE3},
+        &hashSequential},
+    Implementation<crypto::Sha256BatchFunction>{
+        "avx2", {CpuFeature::AVX2}, &hashAvx2},
+#endif
+    Implementation<crypto::Sha256BatchFunction>{
+        "sequential", {}, &hashSequential},
+};
+
+} // namespace
+
+export namespace jt::crypto {
+
+/// Return the implementations of @c sha256Batch from the best to the
+/// sequential one, e.g. to test all of them that the host supports.
+span<const Implementation<Sha256BatchFunction>> sha256BatchImplementations() {
+  return batchImplementationList;
+}
+
+/// Compute the SHA-256 digests of many independent messages at once.
+/// With AVX-512 or AVX2 sixteen or eight messages are hashed in parallel,
+/// one in each lane of the vector registers. This is much faster than
+/// hashing the messages one after another with the portable compression
+/// function, which can not use the parallelism within the rounds of one
+/// block. Processors with the SHA extensions hash one message at a time,
+/// unless they support AVX-512.
+/// @returns the digests in the order of @c messages, formatted like
+/// @c Sha256Sum::digest.
+/// @sa Sha256Sum
+vector<string> sha256Batch(span<const string_view> messages)
+    POST(r : r.size() == messages.size()) {
+  static auto *const batch =
+      selectImplementation(span{batchImplementationList}).function;
+
+  auto states = vector<array<u32, 8>>(messages.size());
+  batch(messages, states);
+
+  auto digests = vector<string>{};
+  digests.reserve(messages.size());
+  ranges::transform(states, back_inserter(digests), hexDigest);
+  return digests;
+}
+
+} // namespace jt::crypto
@@ -0,0 +1,155 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Crypto:Sha256Tree;
+
+import :Sha256;
+
+import jt.Core;
+import std;
+
+using namespace std;
+
+namespace {
+using namespace jt;
+
+using Digest = array<byte, 32>;
+
+/// Domain separation of leaves and inner nodes, see RFC 6962, Section 2.1.
+constexpr auto leafPrefix = array{byte{0x00}};
+constexpr auto nodePrefix = array{byte{0x01}};
+
+Digest hashLeaf(span<const byte> chunk) {
+  auto hasher = crypto::Sha256Sum{};
+  hasher.process(span{leafPrefix});
+  hasher.process(chunk);
+  return hasher.digest_bytes();
+}
+
+/// Merkle Tree Hash of RFC 6962, Section 2.1, for at least one leaf.
+Digest hashTree(span<const Digest> leaves) PRE(!leaves.empty()) {
+  if (leaves.size() == 1U) {
+    return leaves.front();
+  }
+  const auto split = bit_floor(leaves.size() - 1U);
+  const auto left  = hashTree(leaves.first(split));
+  const auto right = hashTree(leaves.subspan(split));
+
+  auto hasher = crypto::Sha256Sum{};
+  hasher.process(span{nodePrefix});
+  hasher.process(left);
+  hasher.process(right);
+  return hasher.digest_bytes();
+}
+
+} // namespace
+
+export namespace jt::crypto {
+
+/// Tree hash based on SHA-256, whose work can be distributed on many threads.
+/// It is meant to check the integrity of huge files, whose plain SHA-256
+/// would be a single sequential chain of compressions.
+///
+/// The format is the Merkle Tree Hash of RFC 6962, Section 2.1, with chunks
+/// of @c chunkSize bytes of the input as leaves, of which only the last one
+/// may be shorter:
+/// - An empty input hashes to SHA-256 of the empty string.
+/// - A leaf hashes to SHA-256(0x00 || chunk).
+/// - @c n > 1 leaves hash to SHA-256(0x01 || left || right), where @c left
+///   is the tree hash of the first @c k leaves, @c right the one of the
+///   other leaves, and @c k the largest power of two smaller than @c n.
+///
+/// The digest depends on the chunk size, which must be the same to compare
+/// digests. It differs from the plain SHA-256 of the input, even for inputs
+/// of a single chunk.
+/// @sa Sha256Sum
+class Sha256Tree {
+public:
+  static constexpr usize defaultChunkSize = usize{1U} << 20U;
+
+  /// Hashes the chunks on up to @c threads threads.
+  explicit Sha256Tree(usize chunkSize = defaultChunkSize,
+                      usize threads   = hardwareThreads())
+      PRE(chunkSize > 0U && threads > 0U)
+      : _chunkSize{chunkSize}, _threads{threads} {}
+
+  /// Appends @c bytes to the input. Full chunks are hashed in parallel
+  /// directly from @c bytes, only an incomplete tail is buffered.
+  /// @throws runtime_error if the digest was already computed.
+  void process(span<const byte> bytes);
+  void process(string_view str) { process(as_bytes(span{str})); }
+
+  /// Returns the root of the tree as hex string, like @c Sha256Sum::digest.
+  string digest() POST(r : r.size() == 64);
+  /// Returns the root of the tree as bytes.
+  array<byte, 32> digest_bytes();
+  void reset();
+
+  [[nodiscard]] usize chunkSize() const noexcept { return _chunkSize; }
+
+private:
+  /// Hash @c bytes as consecutive chunks, of which only the last may be
+  /// shorter, and append them to the leaves.
+  void _hashChunks(span<const byte> bytes);
+
+  usize _chunkSize;
+  usize _threads;
+  /// Input, that is not hashed yet. Up to one chunk per thread is collected,
+  /// so that small pieces of input, e.g. from a pipe, are hashed in parallel
+  /// as well.
+  vector<byte> _pending;
+  vector<Digest> _leaves;
+  optional<Digest> _root;
+};
+
+void Sha256Tree::process(span<const byte> bytes) {
+  if (_root) {
+    throw runtime_error{"Digest Computed, Can not further update Message"};
+  }
+  const usize batchSize = _chunkSize * _threads;
+  if (!_pending.empty()) {
+    const auto count = min(bytes.size(), batchSize - _pending.size());
+    _pending.insert(_pending.end(), bytes.begin(),
+                    bytes.begin() + static_cast<ptrdiff_t>(count));
+    bytes = bytes.subspan(count);
+    if (_pending.size() < batchSize) {
+      return;
+    }
+    _hashChunks(_pending);
+    _pending.clear();
+  }
+
+  const usize full = bytes.size() - bytes.size() % _chunkSize;
+  _hashChunks(bytes.first(full));
+  _pending.assign(bytes.begin() + static_cast<ptrdiff_t>(full), bytes.end());
+}
+
+string Sha256Tree::digest() { return hexString(digest_bytes()); }
+array<byte, 32> Sha256Tree::digest_bytes() {
+  if (!_root) {
+    _hashChunks(_pending);
+    _pending.clear();
+    _root = _leaves.empty() ? Sha256Sum{}.digest_bytes() : hashTree(_leaves);
+  }
+  return *_root;
+}
+
+void Sha256Tree::reset() {
+  _pending.clear();
+  _leaves.clear();
+  _root.reset();
+}
+
+void Sha256Tree::_hashChunks(span<const byte> bytes) {
+  const usize count = (bytes.size() + _chunkSize - 1U) / _chunkSize;
+  const usize first = _leaves.size();
+  _leaves.resize(first + count);
+  parallelFor(count, _threads, [&](usize i) {
+    const auto offset  = i * _chunkSize;
+    const auto chunk   = min(_chunkSize, bytes.size() - offset);
+    _leaves[first + i] = hashLeaf(bytes.subspan(offset, chunk));
+  });
+}
+
+} // namespace jt::crypto
@@ -4,6 +4,7 @@ module;
 
 export module jt.Math:BigUInt;
 
+import :Limbs;
 import :NaturalNumberAlgorithms;
 
 import std;
@@ -17,6 +18,8 @@ namespace jt::math {
 
 /// Arbitrary sized unsigned integer type, stored as @c container::BitVector.
 /// The vector is always normalized, meaning it does not have leading zeros.
+/// The arithmetic works on the 64-bit words of the vector with the kernels of
+/// @c jt.Math:Limbs.
 export class BigUInt {
 public:
   BigUInt() = default;
@@ -24,6 +27,14 @@ public:
   /// Construct the number from a builtin unsigned integer @c value.
   explicit BigUInt(unsigned_integral auto value);
 
+  /// Construct the number from the limbs of @c view.
+  explicit BigUInt(NaturalNView view);
+
+  /// Return a view of the words, that is valid until this number changes.
+  [[nodiscard]] NaturalNView view() const noexcept {
+    return NaturalNView{_limbs()};
+  }
+
   /// Returns the number of bits this number requires.
   [[nodiscard]] usize binaryDigits() const noexcept { return _bits.size(); }
 
@@ -100,6 +111,10 @@ public:
   template <unsigned_integral Target> Target convertTo() const;
 
 private:
+  [[nodiscard]] span<const limbs::limb> _limbs() const noexcept {
+    return _bits.words();
+  }
+
   container::BitVector _bits;
 };
 
@@ -149,18 +164,10 @@ BigUInt &BigUInt::operator/=(unsigned_integral auto value) {
 }
 
 template <unsigned_integral Target> Target BigUInt::convertTo() const {
-  Target result{0U};
-  if (*this > numeric_limits<Target>::max()) {
+  if (binaryDigits() > numeric_limits<Target>::digits) {
     throw out_of_range{"Conversion would narrow"};
   }
-
-  for (usize i = 0U; i < _bits.size(); i++) {
-    if (_bits.get(i)) {
-      result |= (1U << i);
-    }
-  }
-
-  return result;
+  return _limbs().empty() ? Target{0U} : static_cast<Target>(_limbs()[0]);
 }
 
 export inline BigUInt operator+(BigUInt a, const BigUInt &b) { return a += b; }
@@ -206,6 +213,12 @@ export inline BigUInt operator%(BigUInt a, unsigned_integral auto b) {
 export inline bool isEven(const BigUInt &n) noexcept { return n.isEven(); }
 export inline bool isOdd(const BigUInt &n) noexcept { return n.isOdd(); }
 
+BigUInt::BigUInt(NaturalNView view)
+    : _bits{view.size() * limbs::bitsPerLimb, false} {
+  ranges::copy(view.limbs(), _bits.words().begin());
+  _bits.normalize();
+}
+
 bool BigUInt::operator==(const BigUInt &other) const noexcept {
   return (*this <=> other) == strong_ordering::equal;
 }
@@ -219,21 +232,9 @@ strong_ordering BigUInt::operator<=>(const BigUInt &other) const noexcept {
 
   CONTRACT_ASSERT(other.binaryDigits() == binaryDigits());
 
-  if (binaryDigits() == usize{0ULL}) {
-    return strong_ordering::equal;
-  }
-
-  for (usize i = binaryDigits(); i > 0; --i) {
-    const usize idx = i - 1;
-    if (_bits.get(idx) != other._bits.get(idx)) {
-      // *this is smaller than @c other if the first differing digit is 'false'.
-      // Otherwise @c other is smaller.
-      return !_bits.get(idx) ? strong_ordering::less : strong_ordering::greater;
-    }
-  }
-
-  // All digits are identical, so this number is not smaller than @c other.
-  return strong_ordering::equal;
+  // The same number of digits is stored in the same number of words, that
+  // are compared from the most significant one downwards.
+  return limbs::cmp(_limbs(), other._limbs());
 }
 
 BigUInt &BigUInt::operator+=(const BigUInt &other) {
@@ -243,40 +244,19 @@ BigUInt &BigUInt::operator+=(const BigUInt &other) {
   }
 
   // 1. Extend the data storage by enough bits to guarantee that the result is
-  //    representable.
-  while (other.binaryDigits() > binaryDigits()) {
-    _bits.push_back(false);
-  }
-  // Push one bit as a potential carry bit.
-  _bits.push_back(false);
-
-  // 2. Execute the addition of the other number digits to @c this until
-  //    @c other is exhausted.
-  bool carry            = false;
-  usize i               = 0;
-  const usize minDigits = other.binaryDigits();
-  for (; i < minDigits; ++i) {
-    const bool digitSum  = other._bits.get(i) ^ _bits.get(i);
-    const bool nextCarry = other._bits.get(i) && _bits.get(i);
-
-    _bits.set(i, digitSum ^ carry);
-    carry = nextCarry || (digitSum && carry);
-  }
-
-  // 3. There might be an overflow, meaning the @c carry is positive after the
-  //    addition of the minimal amount of digits. The other number is exhausted,
-  //    but the carry must be added to @c this properly.
-  for (const usize maxDigits = binaryDigits(); i < maxDigits; ++i) {
-    const bool digitSum  = carry ^ _bits.get(i);
-    const bool nextCarry = carry && _bits.get(i);
-
-    _bits.set(i, digitSum);
-    carry = nextCarry;
-
-    if (!carry) {
-      break;
-    }
-  }
+  //    representable, including one potential carry bit.
+  _bits.resize(max(binaryDigits(), other.binaryDigits()) + 1U);
+
+  // 2. Add the words of @c other and propagate the carry through the
+  //    remaining words of @c this. The final carry is always zero, because of
+  //    the additional bit.
+  const auto words   = _bits.words();
+  const auto summand = other._limbs();
+  const usize n      = summand.size();
+  const auto carry   = limbs::add_n(words.first(n), words.first(n), summand);
+  const auto overflow [[maybe_unused]] =
+      limbs::add_1(words.subspan(n), words.subspan(n), carry);
+  CONTRACT_ASSERT(overflow == 0U);
 
   _bits.normalize();
   return *this;
@@ -306,60 +286,21 @@ BigUInt &BigUInt::operator-=(const BigUInt &other) {
 
   CONTRACT_ASSERT(magnitudeRelation == strong_ordering::greater);
 
-  // 1. Subtract @c other from @c this by subtracting each digit individually.
-  //    If @c 0 - 1 is executed, the subtraction "borrows" from the next digit.
-  bool borrow           = false;
-  usize i               = 0;
-  const usize minDigits = other.binaryDigits();
-  for (; i < minDigits; ++i) {
-    const bool digitDifference = other._bits.get(i) ^ _bits.get(i);
-    const bool nextBorrow      = other._bits.get(i) && !_bits.get(i);
-
-    _bits.set(i, digitDifference ^ borrow);
-    borrow = nextBorrow || (!digitDifference && borrow);
-  }
-
-  // 2. There might be an overflow, meaning the @c borrow is positive after the
-  //    subtraction of the minimal amount of digits. The other number is
-  //    exhausted, but the borrow must be subtracted from @c this properly.
-  for (const usize maxDigits = binaryDigits(); i < maxDigits; ++i) {
-    const bool digitDifference = borrow ^ _bits.get(i);
-    const bool nextBorrow      = borrow && !_bits.get(i);
-
-    _bits.set(i, digitDifference);
-    borrow = nextBorrow;
-
-    if (!borrow) {
-      break;
-    }
-  }
+  // Subtract the words of @c other and propagate the borrow through the
+  // remaining words of @c this. Because @c this is bigger, there is no borrow
+  // out of the highest word.
+  const auto words      = _bits.words();
+  const auto subtrahend = other._limbs();
+  const usize n         = subtrahend.size();
+  const auto borrow = limbs::sub_n(words.first(n), words.first(n), subtrahend);
+  const auto underflow [[maybe_unused]] =
+      limbs::sub_1(words.subspan(n), words.subspan(n), borrow);
+  CONTRACT_ASSERT(underflow == 0U);
 
   _bits.normalize();
   return *this;
 }
 
-static BigUInt egyptianMultiplication(BigUInt n, BigUInt a) {
-  const auto one                = BigUInt{1U};
-  const auto multiplyAccumulate = [&one](BigUInt accumulator, BigUInt _n,
-                                         BigUInt _a) {
-    while (true) {
-      if (_n.isOdd()) {
-        accumulator += _a;
-        if (_n == one) {
-          return accumulator;
-        }
-      }
-      _n >>= 1;
-      _a += _a;
-    }
-  };
-
-  if (n == one) {
-    return a;
-  }
-  return multiplyAccumulate(BigUInt{0U}, move(n), move(a));
-}
-
 BigUInt &BigUInt::operator*=(const BigUInt &other) {
   if (binaryDigits() == 0U) {
     return *this;
@@ -368,7 +309,12 @@ BigUInt &BigUInt::operator*=(const BigUInt &other) {
     _bits = container::BitVector{};
     return *this;
   }
-  *this = egyptianMultiplication(*this, other);
+  // The product has at most as many digits as both factors together.
+  auto product = container::BitVector{
+      (_limbs().size() + other._limbs().size()) * limbs::bitsPerLimb, false};
+  limbs::mul(product.words(), _limbs(), other._limbs());
+  product.normalize();
+  _bits = move(product);
   return *this;
 }
 
@@ -409,11 +355,20 @@ bool BigUInt::isEven() const noexcept {
   return _bits.size() == 0U || !_bits.get(0U);
 }
 
-static BigUInt largestDoubling(const BigUInt &a, BigUInt b) PRE(b != 0U) {
-  while ((a - b) >= b) {
-    b <<= 1;
+/// Returns the largest @c b*2^k that is not bigger than @c a, together with
+/// @c k. The shift is derived from the difference in digits, so that only a
+/// single shift and comparison are necessary.
+static pair<BigUInt, usize> largestDoubling(const BigUInt &a, BigUInt b)
+    PRE(b != 0U && b <= a) {
+  usize shift = a.binaryDigits() - b.binaryDigits();
+  if (shift > 0U) {
+    b <<= static_cast<int>(shift);
+  }
+  if (b > a) {
+    b >>= 1;
+    --shift;
   }
-  return b;
+  return {b, shift};
 }
 
 pair<BigUInt, BigUInt> divmod(BigUInt dividend, const BigUInt &divisor) {
@@ -427,12 +382,12 @@ pair<BigUInt, BigUInt> divmod(BigUInt dividend, const BigUInt &divisor) {
   if (dividend < divisor) {
     return {BigUInt{0U}, dividend};
   }
-  BigUInt helper = largestDoubling(dividend, divisor);
+  auto [helper, shift] = largestDoubling(dividend, divisor);
   BigUInt quotient{1U};
 
   dividend -= helper;
 
-  while (helper != divisor) {
+  for (; shift > 0U; --shift) {
     // Half 'c' with a shift.
     helper >>= 1U;
     // Double 'quotient' with a shift.
@@ -0,0 +1,312 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Math:Limbs;
+
+import std;
+import jt.Core;
+
+using namespace std;
+
+/// Low level kernels for natural numbers that are stored as little endian
+/// sequence of machine words, called limbs. The naming follows the @c mpn
+/// layer of GMP.
+/// The kernels never allocate. The result may alias an input of the same
+/// length, e.g. @c add_n(a, a, b) adds @c b to @c a in place.
+/// @c NaturalN and @c BigUInt implement their arithmetic with these kernels,
+/// so that optimizing a kernel speeds up all number types.
+namespace jt::math::limbs {
+
+export using limb                  = u64;
+export constexpr usize bitsPerLimb = numeric_limits<limb>::digits;
+
+__extension__ typedef unsigned __int128 doubleLimb;
+
+/// Return @c a + @c b + @c carry and set @c carry to the carry out.
+inline limb addWithCarry(limb a, limb b, limb &carry) noexcept {
+#if __has_builtin(__builtin_addcll)
+  unsigned long long carryOut = 0U;
+  const limb sum              = __builtin_addcll(a, b, carry, &carryOut);
+  carry                       = carryOut;
+  return sum;
+#else
+  limb sum         = 0U;
+  const bool first = __builtin_add_overflow(a, b, &sum);
+  const bool then  = __builtin_add_overflow(sum, carry, &sum);
+  carry            = limb{first || then};
+  return sum;
+#endif
+}
+
+/// Return @c a - @c b - @c borrow and set @c borrow to the borrow out.
+inline limb subWithBorrow(limb a, limb b, limb &borrow) noexcept {
+#if __has_builtin(__builtin_subcll)
+  unsigned long long borrowOut = 0U;
+  const limb difference        = __builtin_subcll(a, b, borrow, &borrowOut);
+  borrow                       = borrowOut;
+  return difference;
+#else
+  limb difference  = 0U;
+  const bool first = __builtin_sub_overflow(a, b, &difference);
+  const bool then  = __builtin_sub_overflow(difference, borrow, &difference);
+  borrow           = limb{first || then};
+  return difference;
+#endif
+}
+
+/// Compute @c r = @c a + @c b and return the carry out of the highest limb.
+export limb add_n(span<limb> r, span<const limb> a, span<const limb> b)
+    PRE(r.size() == a.size() && a.size() == b.size()) {
+  limb carry = 0U;
+  for (usize i = 0U; i < r.size(); ++i) {
+    r[i] = addWithCarry(a[i], b[i], carry);
+  }
+  return carry;
+}
+
+/// Compute @c r = @c a + @c b for a single limb @c b and return the carry.
+export limb add_1(span<limb> r, span<const limb> a, limb b)
+    PRE(r.size() == a.size()) {
+  limb carry = b;
+  for (usize i = 0U; i < r.size(); ++i) {
+    r[i] = addWithCarry(a[i], 0U, carry);
+  }
+  return carry;
+}
+
+/// Compute @c r = @c a - @c b and return the borrow out of the highest limb.
+/// A borrow of @c 1 means, that @c r holds @c a - @c b + 2^(64 * r.size()).
+export limb sub_n(span<limb> r, span<const limb> a, span<const limb> b)
+    PRE(r.size() == a.size() && a.size() == b.size()) {
+  limb borrow = 0U;
+  for (usize i = 0U; i < r.size(); ++i) {
+    r[i] = subWithBorrow(a[i], b[i], borrow);
+  }
+  return borrow;
+}
+
+/// Compute @c r = @c a - @c b for a single limb @c b and return the borrow.
+export limb sub_1(span<limb> r, span<const limb> a, limb b)
+    PRE(r.size() == a.size()) {
+  limb borrow = b;
+  for (usize i = 0U; i < r.size(); ++i) {
+    r[i] = subWithBorrow(a[i], 0U, borrow);
+  }
+  return borrow;
+}
+
+/// Compare two numbers of the same number of limbs.
+export strong_ordering cmp(span<const limb> a, span<const limb> b)
+    PRE(a.size() == b.size()) {
+  for (usize i = a.size(); i > 0U; --i) {
+    if (a[i - 1U] != b[i - 1U]) {
+      return a[i - 1U] <=> b[i - 1U];
+    }
+  }
+  return strong_ordering::equal;
+}
+
+/// Compute @c r = @c a * @c b and return the limb that is carried out.
+export limb mul_1(span<limb> r, span<const limb> a, limb b)
+    PRE(r.size() == a.size()) {
+  limb carry = 0U;
+  for (usize i = 0U; i < r.size(); ++i) {
+    const doubleLimb product = doubleLimb{a[i]} * b + carry;
+    r[i]                     = static_cast<limb>(product);
+    carry                    = static_cast<limb>(product >> bitsPerLimb);
+  }
+  return carry;
+}
+
+/// Portable implementation of @c addmul_1.
+limb addmul_1Portable(span<limb> r, span<const limb> a, limb b) {
+  limb carry = 0U;
+  for (usize i = 0U; i < r.size(); ++i) {
+    // (2^64 - 1)^2 + 2 * (2^64 - 1) == 2^128 - 1 can not overflow.
+    const doubleLimb product = doubleLimb{a[i]} * b + r[i] + carry;
+    r[i]                     = static_cast<limb>(product);
+    carry                    = static_cast<limb>(product >> bitsPerLimb);
+  }
+  return carry;
+}
+
+#if defined(__x86_64__)
+/// Implementation of @c addmul_1 with two independent carry chains.
+/// @c mulx multiplies without touching the flags, @c adcx adds the high limb
+/// of the previous product through the carry flag and @c adox adds the limb
+/// of @c r through the overflow flag. The loop counter uses @c lea and
+/// @c jrcxz, which keep both flags intact.
+limb addmul_1Adx(span<limb> r, span<const limb> a, limb b) {
+  limb *rp       = r.data();
+  const limb *ap = a.data();
+  usize n        = r.size();
+  limb carry     = 0U;
+  __asm__("xor %%eax, %%eax\n\t"
+          "1:\n\t"
+          "jrcxz 2f\n\t"
+          "mulx (%[ap]), %%r8, %%r9\n\t"
+          "adcx %%rax, %%r8\n\t"
+          "adox (%[rp]), %%r8\n\t"
+          "mov %%r8, (%[rp])\n\t"
+          "mov %%r9, %%rax\n\t"
+          "lea 8(%[ap]), %[ap]\n\t"
+          "lea 8(%[rp]), %[rp]\n\t"
+          "lea -1(%%rcx), %%rcx\n\t"
+          "jmp 1b\n\t"
+          "2:\n\t"
+          // The final carry is the last high limb plus both flags.
+          "mov $0, %%r8d\n\t"
+          "adcx %%r8, %%rax\n\t"
+          "adox %%r8, %%rax\n\t"
+          : "=&a"(carry), [rp] "+&r"(rp), [ap] "+&r"(ap), "+c"(n)
+          : "d"(b)
+          : "r8", "r9", "cc", "memory");
+  return carry;
+}
+#endif
+
+export using AddMulFunction = limb(span<limb>, span<const limb>, limb);
+
+constexpr auto addmulImplementationList = array{
+#if defined(__x86_64__)
+    Implementation<AddMulFunction>{
+        "bmi2,adx", {CpuFeature::BMI2, CpuFeature::ADX}, &addmul_1Adx},
+#endif
+    Implementation<AddMulFunction>{"portable", {}, &addmul_1Portable},
+};
+
+/// Return the implementations of @c addmul_1 from the best to the portable
+/// one, e.g. to test all of them that the host supports.
+export span<const Implementation<AddMulFunction>> addmulImplementations() {
+  return addmulImplementationList;
+}
+
+/// Return the best @c addmul_1 for the host, which is selected once.
+AddMulFunction *bestAddmul() {
+  static AddMulFunction *const function =
+      selectImplementation(span{addmulImplementationList}).function;
+  return function;
+}
+
+/// Compute @c r += @c a * @c b and return the limb that is carried out.
+/// This is the inner loop of the schoolbook multiplication. It uses
+/// @c mulx, @c adcx and @c adox if the processor supports BMI2 and ADX.
+export limb addmul_1(span<limb> r, span<const limb> a, limb b)
+    PRE(r.size() == a.size()) {
+  return bestAddmul()(r, a, b);
+}
+
+/// Compute @c r -= @c a * @c b and return the limb that is borrowed.
+/// This is the inner loop of the schoolbook division.
+export limb submul_1(span<limb> r, span<const limb> a, limb b)
+    PRE(r.size() == a.size()) {
+  limb borrow = 0U;
+  for (usize i = 0U; i < r.size(); ++i) {
+    const doubleLimb product = doubleLimb{a[i]} * b + borrow;
+    const auto low           = static_cast<limb>(product);
+    const auto underflow     = limb{r[i] < low};
+    r[i] -= low;
+    // The high limb is at most 2^64 - 2, so adding the borrow can not wrap.
+    borrow = static_cast<limb>(product >> bitsPerLimb) + underflow;
+  }
+  return borrow;
+}
+
+/// Compute @c r = @c a * 2^count and return the bits shifted out of the
+/// highest limb in the lowest @c count bits.
+/// The limbs are processed from the top, so @c r may overlap with @c a if it
+/// starts at the same or a higher address.
+export limb lshift(span<limb> r, span<const limb> a, unsigned count)
+    PRE(r.size() == a.size() && count > 0U && count < bitsPerLimb) {
+  if (a.empty()) {
+    return 0U;
+  }
+  const auto back = static_cast<unsigned>(bitsPerLimb) - count;
+  const limb out  = a.back() >> back;
+  for (usize i = a.size() - 1U; i > 0U; --i) {
+    r[i] = (a[i] << count) | (a[i - 1U] >> back);
+  }
+  r[0] = a[0] << count;
+  return out;
+}
+
+/// Compute @c r = @c a / 2^count and return the bits shifted out of the
+/// lowest limb in the highest @c count bits.
+/// The limbs are processed from the bottom, so @c r may overlap with @c a if
+/// it starts at the same or a lower address.
+export limb rshift(span<limb> r, span<const limb> a, unsigned count)
+    PRE(r.size() == a.size() && count > 0U && count < bitsPerLimb) {
+  if (a.empty()) {
+    return 0U;
+  }
+  const auto back = static_cast<unsigned>(bitsPerLimb) - count;
+  const limb out  = a.front() << back;
+  for (usize i = 0U; i + 1U < a.size(); ++i) {
+    r[i] = (a[i] >> count) | (a[i + 1U] << back);
+  }
+  r.back() = a.back() >> count;
+  return out;
+}
+
+/// Compute @c r = @c a * @c b with the schoolbook method.
+/// @pre @c r does not overlap with @c a or @c b.
+export void mul(span<limb> r, span<const limb> a, span<const limb> b)
+    PRE(r.size() == a.size() + b.size()) {
+  auto *const addmul = bestAddmul();
+  ranges::fill(r, limb{0U});
+  for (usize j = 0U; j < b.size(); ++j) {
+    r[a.size() + j] = addmul(r.subspan(j, a.size()), a, b[j]);
+  }
+}
+
+} // namespace jt::math::limbs
+
+namespace jt::math {
+
+/// Non-owning, read only view of a natural number as span of limbs.
+/// Leading zero limbs are dropped on construction, so the view is always
+/// normalized and zero has no limbs at all.
+/// The view is valid as long as the number it refers to is not modified.
+/// @sa NaturalN::view, BigUInt::view
+export class NaturalNView {
+public:
+  NaturalNView() = default;
+
+  explicit NaturalNView(span<const limbs::limb> digits) : _limbs{digits} {
+    while (!_limbs.empty() && _limbs.back() == 0U) {
+      _limbs = _limbs.first(_limbs.size() - 1U);
+    }
+  }
+
+  [[nodiscard]] span<const limbs::limb> limbs() const noexcept {
+    return _limbs;
+  }
+  [[nodiscard]] usize size() const noexcept { return _limbs.size(); }
+  [[nodiscard]] bool isZero() const noexcept { return _limbs.empty(); }
+  [[nodiscard]] bool isEven() const noexcept {
+    return _limbs.empty() || (_limbs.front() & 1U) == 0U;
+  }
+
+  /// Returns the number of bits this number requires.
+  [[nodiscard]] usize binaryDigits() const noexcept {
+    return _limbs.empty() ? 0U
+                          : _limbs.size() * limbs::bitsPerLimb -
+                                static_cast<usize>(countl_zero(_limbs.back()));
+  }
+
+  bool operator==(const NaturalNView &other) const noexcept {
+    return (*this <=> other) == strong_ordering::equal;
+  }
+  strong_ordering operator<=>(const NaturalNView &other) const noexcept {
+    if (size() != other.size()) {
+      return size() <=> other.size();
+    }
+    return limbs::cmp(_limbs, other._limbs);
+  }
+
+private:
+  span<const limbs::limb> _limbs;
+};
+
+} // namespace jt::math
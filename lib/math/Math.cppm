@@ -8,8 +8,11 @@ export import :BigUInt;
 export import :Concepts;
 export import :FixedSquareMatrix;
 export import :GenericPower;
+export import :Limbs;
 export import :ModularArithmetic;
 export import :NaturalN;
 export import :NaturalNumberAlgorithms;
+export import :PrimeSieve;
+export import :PrimeTable;
 export import :Rational;
 export import :Operations;
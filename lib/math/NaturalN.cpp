@@ -4,6 +4,8 @@ module;
 
 export module jt.Math:NaturalN;
 
+import :Limbs;
+
 import std;
 import jt.Core;
 
@@ -13,6 +15,8 @@ export namespace jt::math {
 
 /// Represents an arbitrary natural number, using @c BigUInt logic with builtin
 /// interger types instead of individual bits.
+/// The digits are 64-bit limbs, that share the kernels of @c jt.Math:Limbs
+/// with @c BigUInt.
 class NaturalN {
 public:
   NaturalN() { _digits.reserve(8); }
@@ -20,6 +24,9 @@ public:
   /// Construct the number from a builtin unsigned integer @c value.
   explicit NaturalN(unsigned_integral auto value);
 
+  /// Construct the number from the limbs of @c view.
+  explicit NaturalN(NaturalNView view);
+
   NaturalN(const NaturalN &other)            = default;
   NaturalN(NaturalN &&other)                 = default;
 
@@ -40,6 +47,11 @@ public:
       POST(_digits.empty() || _digits.back() != 0U);
   NaturalN &operator>>=(int value) PRE(value >= 0);
 
+  /// Return a view of the limbs, that is valid until this number changes.
+  [[nodiscard]] NaturalNView view() const noexcept {
+    return NaturalNView{_digits};
+  }
+
   [[nodiscard]] bool isEven() const noexcept;
   [[nodiscard]] bool isOdd() const noexcept { return !isEven(); }
 
@@ -51,8 +63,8 @@ public:
 private:
   void _normalize();
 
-  vector<u32> _digits;
-  constexpr static int bitsPerDigit{8 * sizeof(u32)};
+  vector<limbs::limb> _digits;
+  constexpr static int bitsPerDigit{limbs::bitsPerLimb};
 };
 
 /// Represents an arbitrary natural number, using @c BigUInt logic with builtin
@@ -61,11 +73,9 @@ NaturalN::NaturalN(unsigned_integral auto value) {
   if (value > numeric_limits<u64>::max()) {
     throw invalid_argument{"Maximal u64::max allowed for int constructor"};
   }
-  _digits.reserve(32);
-  u64 v{value};
-  while (v > 0U) {
-    _digits.emplace_back(static_cast<u32>(v));
-    v >>= unsigned{bitsPerDigit};
+  _digits.reserve(16);
+  if (value > 0U) {
+    _digits.emplace_back(limbs::limb{value});
   }
 }
 
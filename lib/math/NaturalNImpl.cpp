@@ -5,6 +5,7 @@ module;
 module jt.Math:NaturalN.Impl;
 
 import :GenericPower;
+import :Limbs;
 import :NaturalN;
 import :NumberIO;
 
@@ -16,38 +17,13 @@ using namespace std;
 namespace jt::math {
 
 template <unsigned_integral Target> Target NaturalN::convertTo() const {
-  Target result{0U};
   if (_digits.empty()) {
-    return result;
+    return Target{0U};
   }
-  CONTRACT_ASSERT(!_digits.empty());
-  if constexpr (is_same_v<Target, u64>) {
-    if (_digits.size() > 2) {
-      throw out_of_range{"Conversion would narrow"};
-    }
-    result += !_digits.empty() ? Target{_digits[0]} : 0U;
-    result += _digits.size() > 1U ? Target{_digits[1]} : 0U;
-  }
-  if constexpr (is_same_v<Target, u32>) {
-    if (_digits.size() > 1) {
-      throw out_of_range{"Conversion would narrow"};
-    }
-    return _digits[0];
-  }
-  if constexpr (is_same_v<Target, u16>) {
-    if (_digits.size() > 1 || _digits[0] > numeric_limits<u16>::max()) {
-      throw out_of_range{"Conversion would narrow"};
-    }
-    return Target(_digits[0]);
-  }
-  if constexpr (is_same_v<Target, u8>) {
-    if (_digits.size() > 1 || _digits[0] > numeric_limits<u8>::max()) {
-      throw out_of_range{"Conversion would narrow"};
-    }
-    return Target(_digits[0]);
+  if (_digits.size() > 1U || _digits[0] > numeric_limits<Target>::max()) {
+    throw out_of_range{"Conversion would narrow"};
   }
-  CONTRACT_ASSERT(false &&
-                  "Unreachable, because all integral types are handled");
+  return static_cast<Target>(_digits[0]);
 }
 
 bool NaturalN::operator==(const NaturalN &other) const noexcept {
@@ -64,21 +40,7 @@ strong_ordering NaturalN::operator<=>(const NaturalN &other) const noexcept {
 
   CONTRACT_ASSERT(_digits.size() == other._digits.size());
 
-  if (_digits.empty()) {
-    return strong_ordering::equal;
-  }
-
-  for (usize i = _digits.size(); i > 0; --i) {
-    const auto idx = i - 1;
-    const auto &d1 = _digits[idx];
-    const auto &d2 = other._digits[idx];
-    if (d1 != d2) {
-      return d1 < d2 ? strong_ordering::less : strong_ordering::greater;
-    }
-  }
-
-  // All digits are identical, so this number is not smaller than @c other.
-  return strong_ordering::equal;
+  return limbs::cmp(_digits, other._digits);
 }
 
 NaturalN &NaturalN::operator+=(const NaturalN &other) {
@@ -92,27 +54,16 @@ NaturalN &NaturalN::operator+=(const NaturalN &other) {
   if (other._digits.size() > _digits.size()) {
     _digits.resize(other._digits.size());
   }
-  _digits.emplace_back(u32{0U});
-
-  // 2. Execute the addition of the other number digits to @c this until
-  //    @c other is exhausted.
-  u32 carry = 0U;
-  usize i   = 0U;
-  for (; i < other._digits.size(); ++i) {
-    const u64 sum = u64{_digits[i]} + u64{other._digits[i]} + u64{carry};
-    carry         = static_cast<u32>(sum >> u32(bitsPerDigit));
-    _digits[i]    = static_cast<u32>(sum);
-  }
+  _digits.emplace_back(limbs::limb{0U});
 
-  for (const usize maxDigits = _digits.size(); i < maxDigits; ++i) {
-    const u64 sum = u64{_digits[i]} + u64{carry};
-    carry         = static_cast<u32>(sum >> u32(bitsPerDigit));
-    _digits[i]    = static_cast<u32>(sum);
+  // 2. Add the digits of @c other and propagate the carry through the
+  //    remaining digits of @c this.
+  const auto digits = span{_digits};
+  const usize n     = other._digits.size();
+  const auto carry =
+      limbs::add_n(digits.first(n), digits.first(n), other._digits);
+  limbs::add_1(digits.subspan(n), digits.subspan(n), carry);
 
-    if (carry == 0U) {
-      break;
-    }
-  }
   _normalize();
   return *this;
 }
@@ -141,34 +92,15 @@ NaturalN &NaturalN::operator-=(const NaturalN &other) {
 
   CONTRACT_ASSERT(magnitudeRelation == strong_ordering::greater);
 
-  // 1. Subtract @c other from @c this by subtracting each digit individually.
-  //    If @c 0 - 1 is executed, the subtraction "borrows" from the next digit.
-  u32 borrow = 0U;
-  usize i    = 0;
-  for (; i < other._digits.size(); ++i) {
-    const u32 diff             = _digits[i] - other._digits[i];
-    const u32 nextBorrow       = other._digits[i] > _digits[i] ? 1U : 0U;
-
-    const u32 borrowed         = diff - borrow;
-    const u32 additionalBorrow = borrow > diff ? 1U : 0U;
-
-    _digits[i]                 = borrowed;
-    borrow                     = nextBorrow + additionalBorrow;
-  }
-
-  // 2. There might be an overflow, meaning the @c borrow is positive after the
-  //    subtraction of the minimal amount of digits. The other number is
-  //    exhausted, but the borrow must be subtracted from @c this properly.
-  for (const usize maxDigits = _digits.size(); i < maxDigits; ++i) {
-    const u32 diff       = _digits[i] - borrow;
-    const u32 nextBorrow = borrow > _digits[i] ? 1U : 0U;
-    _digits[i]           = diff;
-    borrow               = nextBorrow;
-
-    if (borrow == u32{0U}) {
-      break;
-    }
-  }
+  // Subtract the digits of @c other and propagate the borrow through the
+  // remaining digits of @c this.
+  const auto digits = span{_digits};
+  const usize n     = other._digits.size();
+  const auto borrow =
+      limbs::sub_n(digits.first(n), digits.first(n), other._digits);
+  const auto underflow [[maybe_unused]] =
+      limbs::sub_1(digits.subspan(n), digits.subspan(n), borrow);
+  CONTRACT_ASSERT(underflow == 0U);
 
   _normalize();
   return *this;
@@ -182,25 +114,12 @@ NaturalN &NaturalN::operator*=(const NaturalN &other) {
     _digits.clear();
     return *this;
   }
-#if 0
-    return *this = power_monoid(*this, other, plus<NaturalN>{});
-#else
-  CONTRACT_ASSERT(!_digits.empty());
-  CONTRACT_ASSERT(!other._digits.empty());
-
-  auto result = NaturalN{0U};
-  for (usize j = 0; j < other._digits.size(); ++j) {
-    auto intermediary = NaturalN{0U};
-
-    for (usize i = 0; i < _digits.size(); ++i) {
-      auto product = NaturalN{u64{_digits[i]} * u64{other._digits[j]}};
-      product <<= int(j + i) * bitsPerDigit;
-      intermediary += product;
-    }
-    result += intermediary;
-  }
-  return *this = result;
-#endif
+
+  auto product = vector<limbs::limb>(_digits.size() + other._digits.size());
+  limbs::mul(product, _digits, other._digits);
+  _digits = move(product);
+  _normalize();
+  return *this;
 }
 NaturalN &NaturalN::operator/=(const NaturalN &other) {
   if (other == 2_U) {
@@ -212,70 +131,59 @@ NaturalN &NaturalN::operator%=(const NaturalN &other) {
   return *this = divmod(*this, other).second;
 }
 NaturalN &NaturalN::operator<<=(int value) {
-  const auto newDigits   = value / bitsPerDigit;
-  const auto bitsToShift = value % bitsPerDigit;
-
-  if (newDigits > 0) {
-    _digits.insert(_digits.begin(), static_cast<usize>(newDigits), 0U);
-  }
-  if (bitsToShift == 0 || _digits.empty()) {
+  if (_digits.empty()) {
     return *this;
   }
-
-  const auto shiftPos  = u32(bitsPerDigit - bitsToShift);
-  const auto upperMask = numeric_limits<u32>::max() << shiftPos;
-
-  if (countl_zero(_digits.back()) < bitsToShift) {
-    _digits.emplace_back(0U);
-  }
-
-  auto carryOver = u32{0U};
-  for (auto &digit : _digits) {
-    const auto nextCarryOver = (digit & upperMask) >> shiftPos;
-    digit <<= u32(bitsToShift);
-    digit |= carryOver;
-    carryOver = nextCarryOver;
+  const auto newDigits   = static_cast<usize>(value / bitsPerDigit);
+  const auto bitsToShift = static_cast<unsigned>(value % bitsPerDigit);
+  const usize oldSize    = _digits.size();
+
+  // Shift the digits in place into the upper part of the grown vector. The
+  // kernel works from the top down, so no digit is overwritten before it is
+  // read.
+  _digits.resize(oldSize + newDigits + 1U);
+  const auto digits = span{_digits};
+  if (bitsToShift == 0U) {
+    copy_backward(digits.begin(), digits.begin() + static_cast<pdiff>(oldSize),
+                  digits.begin() + static_cast<pdiff>(oldSize + newDigits));
+  } else {
+    digits[oldSize + newDigits] = limbs::lshift(
+        digits.subspan(newDigits, oldSize), digits.first(oldSize), bitsToShift);
   }
+  fill_n(digits.begin(), newDigits, limbs::limb{0U});
 
+  _normalize();
   return *this;
 }
 NaturalN &NaturalN::operator>>=(int value) {
-  const auto removeDigits = value / bitsPerDigit;
-  const auto bitsToShift  = value % bitsPerDigit;
+  const auto removeDigits = static_cast<usize>(value / bitsPerDigit);
+  const auto bitsToShift  = static_cast<unsigned>(value % bitsPerDigit);
 
-  if (usize(removeDigits) >= _digits.size()) {
+  if (removeDigits >= _digits.size()) {
     _digits.clear();
     return *this;
   }
 
-  CONTRACT_ASSERT(usize(removeDigits) < _digits.size());
-  _digits.erase(_digits.begin(), _digits.begin() + removeDigits);
-  if (bitsToShift == 0) {
-    return *this;
-  }
-
-  const auto shiftPos  = u32(bitsPerDigit - bitsToShift);
-  const auto lowerMask = numeric_limits<u32>::max() >> shiftPos;
-  CONTRACT_ASSERT(shiftPos < bitsPerDigit);
-
-  if (_digits.size() == 1U) {
-    _digits[0] >>= u32(bitsToShift);
-    _normalize();
-    return *this;
+  // Shift the digits in place towards the front. The kernel works from the
+  // bottom up, so no digit is overwritten before it is read.
+  const usize newSize = _digits.size() - removeDigits;
+  const auto digits   = span{_digits};
+  if (bitsToShift == 0U) {
+    copy(digits.begin() + static_cast<pdiff>(removeDigits), digits.end(),
+         digits.begin());
+  } else {
+    limbs::rshift(digits.first(newSize), digits.subspan(removeDigits),
+                  bitsToShift);
   }
+  _digits.resize(newSize);
 
-  CONTRACT_ASSERT(_digits.size() > 1);
-  for (usize i = 1; i < _digits.size(); ++i) {
-    const auto bitsToPreserve = (_digits[i] & lowerMask) << shiftPos;
-    _digits[i - 1] >>= u32(bitsToShift);
-    _digits[i - 1] |= bitsToPreserve;
-  }
-  _digits.back() >>= u32(bitsToShift);
   _normalize();
-
   return *this;
 }
 
+NaturalN::NaturalN(NaturalNView view)
+    : _digits(view.limbs().begin(), view.limbs().end()) {}
+
 bool NaturalN::isEven() const noexcept {
   if (_digits.empty()) {
     return true;
@@ -284,7 +192,7 @@ bool NaturalN::isEven() const noexcept {
 }
 
 void NaturalN::_normalize() {
-  while (!_digits.empty() && _digits.back() == u32{0U}) {
+  while (!_digits.empty() && _digits.back() == limbs::limb{0U}) {
     _digits.pop_back();
   }
 }
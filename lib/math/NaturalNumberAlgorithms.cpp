@@ -1,7 +1,13 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
 export module jt.Math:NaturalNumberAlgorithms;
 
 import :Concepts;
 import :Operations;
+import :PrimeSieve;
+import :PrimeTable;
 
 import std;
 import jt.Container;
@@ -18,14 +24,27 @@ export namespace jt::math {
 /// @endcode
 template <NaturalNumber N> vector<N> getPrimeFactors(N n);
 
+/// Computes the prime factors like @c getPrimeFactors(n), but only divides by
+/// the primes of @c primes and continues with odd divisors beyond
+/// @c primes.limit().
+/// @sa PrimeTable::load
+template <NaturalNumber N>
+vector<N> getPrimeFactors(N n, const PrimeTable &primes);
+
 /// Checks if a number is prime by determining its prime factors. If the number
 /// is even, it returns early with a @c false.
 /// @sa getPrimeFactors
 template <NaturalNumber N> bool isPrime(NaturalNumber auto n);
 
-/// Computes the prime numbers up to a specific N.
-/// @warning Uses O(N) ~ memory for the computation.
+/// Checks if a number is prime by trial division with the primes of
+/// @c primes up to @c sqrt(n). Only if @c primes.limit() is smaller than
+/// @c sqrt(n), odd divisors are tried beyond it.
+template <NaturalNumber N> bool isPrime(N n, const PrimeTable &primes);
+
+/// Computes the prime numbers below @c maximum with a segmented sieve.
+/// @note The sieve uses O(sqrt(N)) memory, only the result grows with N.
 /// @returns vector of prime numbers.
+/// @sa SegmentedSieve
 template <NaturalNumber N> vector<N> sieveEratosthenes(const usize &maximum);
 
 /// Computes the greatest-common-divisor for natural numbers.
@@ -78,6 +97,81 @@ template <NaturalNumber N> vector<N> getPrimeFactors(N n) {
   return result;
 }
 
+template <NaturalNumber N>
+vector<N> getPrimeFactors(N n, const PrimeTable &primes) {
+  vector<N> result;
+
+  if (n == N{0U} || n == N{1U} || n == N{2U}) {
+    return result;
+  }
+
+  const N originalN{n};
+  // Divides 'n' by 'divisor' as long as there is no remainder. Returns 'false'
+  // if 'divisor' is bigger than sqrt(n). Then the remaining 'n' is prime.
+  const auto divideOut = [&](const N &divisor) {
+    if (divisor * divisor > n) {
+      return false;
+    }
+    auto [quotient, remainder] = divmod(n, divisor);
+    while (remainder == N{0U}) {
+      result.push_back(divisor);
+      n                        = quotient;
+      tie(quotient, remainder) = divmod(n, divisor);
+    }
+    return true;
+  };
+
+  auto searching = true;
+  for (const u64 prime : primes) {
+    if (prime >= primes.limit() || !searching) {
+      break;
+    }
+    searching = divideOut(static_cast<N>(prime));
+  }
+  // The table ends below sqrt(n). Continue with the odd numbers after it, or
+  // with 2 if even that is not part of the table.
+  for (auto divisor = static_cast<N>(
+           primes.limit() <= 2U ? u64{2U} : primes.limit() | 1U);
+       searching; divisor += (divisor == N{2U} ? N{1U} : N{2U})) {
+    searching = divideOut(divisor);
+  }
+
+  // The remainder is the biggest prime factor, unless 'n' itself is prime.
+  if (n != N{1U} && n != originalN) {
+    result.push_back(n);
+  }
+  return result;
+}
+
+template <NaturalNumber N> bool isPrime(N n, const PrimeTable &primes) {
+  if (n == N{0U} || n == N{1U}) {
+    return false;
+  }
+
+  for (const u64 prime : primes) {
+    if (prime >= primes.limit()) {
+      break;
+    }
+    const auto divisor = static_cast<N>(prime);
+    if (divisor * divisor > n) {
+      return true;
+    }
+    if (n % divisor == N{0U}) {
+      return false;
+    }
+  }
+  // The table ends below sqrt(n), see 'getPrimeFactors'.
+  for (auto divisor = static_cast<N>(
+           primes.limit() <= 2U ? u64{2U} : primes.limit() | 1U);
+       divisor * divisor <= n;
+       divisor += (divisor == N{2U} ? N{1U} : N{2U})) {
+    if (n % divisor == N{0U}) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <NaturalNumber N> bool isPrime(N n) {
   if (n == N{0U} || n == N{1U}) {
     return false;
@@ -105,72 +199,268 @@ template <NaturalNumber N> bool isPrime(N n) {
 }
 
 template <NaturalNumber N> vector<N> sieveEratosthenes(const usize &maximum) {
-  // All numbers are potentially prime numbers at the beginning. The algorithm
-  // strikes through specific numbers.
-  container::BitVector sieve{maximum, /*initialValue=*/true};
-
   // This vector stores the determined primes.
   vector<N> collectedPrimes;
+  forEachPrime(0U, maximum, [&collectedPrimes](u64 prime) {
+    collectedPrimes.emplace_back(static_cast<N>(prime));
+  });
+  return collectedPrimes;
+}
 
-  // The number 0 and 1 are not prime numbers.
-  sieve.set(0, false);
-  sieve.set(1, false);
+template <NaturalNumber N> N gcd(N a, N b) {
+  while (b != N{0U}) {
+    a %= b;
+    swap(a, b);
+  }
+  return a;
+}
 
-  // Start striking out with 2U ...
-  usize currentMinimalFactor{2U};
-  // ... and stop at sqrt(maximum). At this point, all prime numbers are
-  // discovered.
-  usize maximalFactor{static_cast<usize>(ceil(sqrt(maximum)))};
+template <NaturalNumber N> N lcm(const N &a, const N &b) {
+  const auto g      = gcd(a, b);
+  const auto p      = a * b;
+  const auto result = p / g;
+  return result;
+}
 
-  while (currentMinimalFactor <= maximalFactor) {
-    collectedPrimes.emplace_back(N{currentMinimalFactor});
+} // namespace jt::math
 
-    // Strike out all multiples of the current prime number.
-    for (usize i = 2U; i < maximum; ++i) {
-      usize strikeOutIndex = currentMinimalFactor * i;
-      if (strikeOutIndex >= maximum) {
+namespace jt::math {
+
+/// Prime factorizations of a batch of numbers, stored contiguously.
+/// The factors of the @c i-th number are @c operator[](i).
+export class PrimeFactorizations {
+public:
+  PrimeFactorizations() = default;
+  /// @pre offsets.front() == 0 && offsets.back() == factors.size()
+  PrimeFactorizations(vector<usize> offsets, vector<u32> factors)
+      : _offsets{std::move(offsets)}, _factors{std::move(factors)} {}
+
+  /// Return the number of factorized numbers.
+  [[nodiscard]] usize size() const noexcept {
+    return _offsets.empty() ? 0U : _offsets.size() - 1U;
+  }
+
+  /// Return the ascending prime factors of the @c i-th number.
+  [[nodiscard]] span<const u32> operator[](usize i) const PRE(i < size()) {
+    return span{_factors}.subspan(_offsets[i], _offsets[i + 1U] - _offsets[i]);
+  }
+
+private:
+  vector<usize> _offsets;
+  vector<u32> _factors;
+};
+
+/// Table of the smallest prime factor of every number below a bound.
+///
+/// The table is computed with a linear sieve, that visits each composite
+/// number exactly once. Afterwards, every number below the bound is factored
+/// with one lookup per prime factor, i.e. at most @c log2(n) lookups.
+/// @note The table needs 4 bytes per number.
+/// @sa getPrimeFactors for the factors of arbitrary numbers
+export class SmallestPrimeFactorTable {
+public:
+  /// Compute the smallest prime factors of all numbers below @c limit.
+  explicit SmallestPrimeFactorTable(u32 limit);
+
+  [[nodiscard]] u32 limit() const noexcept {
+    return static_cast<u32>(_smallestFactor.size());
+  }
+
+  /// Return the smallest prime factor of @c n.
+  [[nodiscard]] u32 smallestPrimeFactor(u32 n) const
+      PRE(n >= 2U && n < limit()) {
+    return _smallestFactor[n];
+  }
+
+  /// Returns @c true if @c n is prime.
+  [[nodiscard]] bool isPrime(u32 n) const PRE(n < limit()) {
+    return n >= 2U && _smallestFactor[n] == n;
+  }
+
+  /// Return all prime factors of @c n in ascending order. Unlike
+  /// @c getPrimeFactors, a prime is its own factor. @c 0 and @c 1 have no
+  /// factors.
+  [[nodiscard]] vector<u32> factorize(u32 n) const PRE(n < limit());
+
+  /// Factor all @c values on up to @c threads threads.
+  /// @throws out_of_range if a value is not below @c limit()
+  template <unsigned_integral T>
+  [[nodiscard]] PrimeFactorizations
+  factorize(span<const T> values, usize threads = hardwareThreads()) const;
+
+  /// Return Euler's totient of @c n, the count of numbers in @c [1, n] that
+  /// are coprime to @c n.
+  [[nodiscard]] u32 totient(u32 n) const PRE(n < limit());
+
+  /// Return the number of divisors of @c n, including @c 1 and @c n.
+  [[nodiscard]] u32 divisorCount(u32 n) const PRE(n < limit());
+
+private:
+  /// Calls @c f(prime, exponent) for each distinct prime factor of @c n.
+  template <typename F> void _forEachPrimePower(u32 n, F &&f) const {
+    while (n > 1U) {
+      const u32 prime = _smallestFactor[n];
+      u32 exponent    = 0U;
+      do {
+        n /= prime;
+        ++exponent;
+      } while (n % prime == 0U);
+      f(prime, exponent);
+    }
+  }
+
+  vector<u32> _smallestFactor;
+};
+
+/// Visits all numbers in @c [2, limit) with a linear sieve.
+/// For each number @c n, @c prime(n) is called if @c n is prime. Afterwards
+/// @c composite(n, p) is called for each multiple @c n*p with a prime @c p up
+/// to the smallest prime factor of @c n, that is also the smallest prime
+/// factor of @c n*p. Every composite is reached exactly once.
+/// @returns the smallest prime factor of every number below @c limit.
+template <typename Prime, typename Composite>
+vector<u32> linearSieve(u32 limit, Prime &&prime, Composite &&composite) {
+  auto smallestFactor = vector<u32>(limit, 0U);
+  auto primes         = vector<u32>{};
+  for (u32 n = 2U; n < limit; ++n) {
+    if (smallestFactor[n] == 0U) {
+      smallestFactor[n] = n;
+      primes.push_back(n);
+      prime(n);
+    }
+    for (const u32 p : primes) {
+      if (p > smallestFactor[n] || u64{n} * p >= limit) {
         break;
       }
-      sieve.set(strikeOutIndex, false);
+      smallestFactor[n * p] = p;
+      composite(n, p);
     }
+  }
+  return smallestFactor;
+}
 
-    // Search for the next not-striked out index in the sieve. This is a prime
-    // number, that will be used for the next iteration.
-    const auto findNextPrime = [&sieve, &maximum](usize currentMinimalPrime) {
-      for (usize i = currentMinimalPrime + usize{1U}; i < maximum; i++) {
-        if (sieve.get(i)) {
-          return i;
-        }
-      }
-      throw runtime_error{"Failed to determine next prime number."
-                          " It should terminate!"};
-    };
-    currentMinimalFactor = findNextPrime(currentMinimalFactor);
+SmallestPrimeFactorTable::SmallestPrimeFactorTable(u32 limit)
+    : _smallestFactor{linearSieve(
+          limit, [](u32 /*p*/) {}, [](u32 /*n*/, u32 /*p*/) {})} {}
+
+vector<u32> SmallestPrimeFactorTable::factorize(u32 n) const {
+  auto factors = vector<u32>{};
+  while (n > 1U) {
+    const u32 prime = _smallestFactor[n];
+    factors.push_back(prime);
+    n /= prime;
   }
+  return factors;
+}
 
-  // Collect all primes that are left from the sieve.
-  for (usize i = currentMinimalFactor; i < maximum; i += usize{2U}) {
-    if (sieve.get(i)) {
-      collectedPrimes.emplace_back(N{i});
-    }
+template <unsigned_integral T>
+PrimeFactorizations
+SmallestPrimeFactorTable::factorize(span<const T> values,
+                                    usize threads) const {
+  if (ranges::any_of(values, [this](T v) { return v >= limit(); })) {
+    throw out_of_range{"Value exceeds the smallest prime factor table"};
   }
 
-  return collectedPrimes;
+  // The factors are counted first, to place the factorizations of each chunk
+  // directly into their final position.
+  constexpr usize chunkSize = 4096U;
+  const usize chunks        = (values.size() + chunkSize - 1U) / chunkSize;
+  const auto forEachChunk   = [&](auto &&f) {
+    parallelFor(chunks, threads, [&](usize chunk) {
+      const usize first = chunk * chunkSize;
+      const usize last  = min(values.size(), first + chunkSize);
+      for (usize i = first; i < last; ++i) {
+        f(i, static_cast<u32>(values[i]));
+      }
+    });
+  };
+
+  auto offsets = vector<usize>(values.size() + 1U, 0U);
+  forEachChunk([&](usize i, u32 n) {
+    usize count = 0U;
+    for (; n > 1U; n /= _smallestFactor[n]) {
+      ++count;
+    }
+    offsets[i + 1U] = count;
+  });
+  partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  auto factors = vector<u32>(offsets.back());
+  forEachChunk([&](usize i, u32 n) {
+    for (usize position = offsets[i]; n > 1U; n /= _smallestFactor[n]) {
+      factors[position++] = _smallestFactor[n];
+    }
+  });
+  return PrimeFactorizations{std::move(offsets), std::move(factors)};
 }
 
-template <NaturalNumber N> N gcd(N a, N b) {
-  while (b != N{0U}) {
-    a %= b;
-    swap(a, b);
+u32 SmallestPrimeFactorTable::totient(u32 n) const {
+  if (n == 0U) {
+    return 0U;
   }
-  return a;
+  u32 result = n;
+  _forEachPrimePower(n, [&result](u32 prime, u32 /*exponent*/) {
+    result = result / prime * (prime - 1U);
+  });
+  return result;
 }
 
-template <NaturalNumber N> N lcm(const N &a, const N &b) {
-  const auto g      = gcd(a, b);
-  const auto p      = a * b;
-  const auto result = p / g;
+u32 SmallestPrimeFactorTable::divisorCount(u32 n) const {
+  if (n == 0U) {
+    return 0U;
+  }
+  u32 result = 1U;
+  _forEachPrimePower(n, [&result](u32 /*prime*/, u32 exponent) {
+    result *= exponent + 1U;
+  });
   return result;
 }
 
+/// Computes Euler's totient of every number below @c limit with a linear
+/// sieve.
+/// @sa SmallestPrimeFactorTable::totient
+export vector<u32> totientTable(u32 limit) {
+  auto totient = vector<u32>(limit, 0U);
+  if (limit > 1U) {
+    totient[1] = 1U;
+  }
+  linearSieve(
+      limit, [&totient](u32 p) { totient[p] = p - 1U; },
+      [&totient](u32 n, u32 p) {
+        // 'p' is the smallest prime factor of 'n * p'. If it divides 'n' as
+        // well, only its exponent grows.
+        totient[n * p] = totient[n] * (n % p == 0U ? p : p - 1U);
+      });
+  return totient;
+}
+
+/// Computes the number of divisors of every number below @c limit with a
+/// linear sieve.
+/// @sa SmallestPrimeFactorTable::divisorCount
+export vector<u32> divisorCountTable(u32 limit) {
+  auto divisors = vector<u32>(limit, 0U);
+  // Exponent of the smallest prime factor of each number.
+  auto exponent = vector<u8>(limit, 0U);
+  if (limit > 1U) {
+    divisors[1] = 1U;
+  }
+  linearSieve(
+      limit,
+      [&](u32 p) {
+        divisors[p] = 2U;
+        exponent[p] = 1U;
+      },
+      [&](u32 n, u32 p) {
+        if (n % p == 0U) {
+          divisors[n * p] =
+              divisors[n] / (exponent[n] + 1U) * (exponent[n] + 2U);
+          exponent[n * p] = static_cast<u8>(exponent[n] + 1U);
+        } else {
+          divisors[n * p] = divisors[n] * 2U;
+          exponent[n * p] = 1U;
+        }
+      });
+  return divisors;
+}
+
 } // namespace jt::math
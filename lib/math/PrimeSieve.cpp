@@ -0,0 +1,456 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Math:PrimeSieve;
+
+import :Concepts;
+
+import std;
+import jt.Core;
+import jt.Container;
+
+using namespace std;
+
+namespace jt::math {
+
+/// Number of odd candidates that are sieved at once. The window is sized to
+/// stay within the L2 cache.
+constexpr usize segmentLength = usize{1U} << 18U;
+
+/// All primes that are removed by the presieve pattern instead of striking
+/// out their multiples. The sieve itself only stores odd numbers, which
+/// handles the @c 2.
+constexpr array<u32, 6> presievedPrimes{2U, 3U, 5U, 7U, 11U, 13U};
+
+/// Period of the presieve pattern in the odd-only index space.
+/// The multiples of 3, 5, 7, 11 and 13 repeat after their product.
+constexpr usize presievePeriod = 3U * 5U * 7U * 11U * 13U;
+
+/// The wheel modulus @c 2*3*5*7. Only multiples @c p*k with @c k coprime to
+/// the modulus must be struck out, the other ones are presieved already.
+constexpr u32 wheelModulus = 2U * 3U * 5U * 7U;
+constexpr usize wheelSize  = 48U;
+
+struct Wheel {
+  /// Distance between two consecutive residues that are coprime to the
+  /// modulus.
+  array<u8, wheelSize> gaps{};
+  /// Distance from any residue to the next residue that is coprime to the
+  /// modulus.
+  array<u8, wheelModulus> nextOffset{};
+  /// Index of the next coprime residue for any residue.
+  array<u8, wheelModulus> nextIndex{};
+};
+
+constexpr Wheel makeWheel() {
+  array<u32, wheelSize> residues{};
+  usize count = 0U;
+  for (u32 r = 0U; r < wheelModulus; ++r) {
+    if (std::gcd(r, wheelModulus) == 1U) {
+      residues[count++] = r;
+    }
+  }
+
+  Wheel w;
+  for (usize k = 0U; k < wheelSize; ++k) {
+    const u32 next = k + 1U < wheelSize ? residues[k + 1U]
+                                        : residues[0] + wheelModulus;
+    w.gaps[k]      = static_cast<u8>(next - residues[k]);
+  }
+  // The largest residue, 209, is coprime to the modulus. Therefore, every
+  // residue has a coprime successor without wrapping around.
+  for (u32 r = 0U, k = 0U; r < wheelModulus; ++r) {
+    while (residues[k] < r) {
+      ++k;
+    }
+    w.nextOffset[r] = static_cast<u8>(residues[k] - r);
+    w.nextIndex[r]  = static_cast<u8>(k);
+  }
+  return w;
+}
+
+constexpr Wheel wheel = makeWheel();
+
+/// Returns the bit pattern of odd numbers, that are not divisible by any
+/// presieved prime. It is copied into each segment before sieving.
+/// The pattern repeats its first word after the period, so that a whole word
+/// can be read at every offset within the period.
+const container::BitVector &presievePattern() {
+  static const auto pattern = [] {
+    const usize length = presievePeriod + container::BitVector::BitsPerWord;
+    container::BitVector bits{length, /*initialValue=*/true};
+    for (usize j = 0U; j < length; ++j) {
+      const u64 n = 2U * j + 1U;
+      for (const u32 p : span{presievedPrimes}.subspan(1)) {
+        if (n % p == 0U) {
+          bits.set(j, false);
+        }
+      }
+    }
+    return bits;
+  }();
+  return pattern;
+}
+
+u64 isqrt(u64 n) {
+  auto r = static_cast<u64>(sqrt(static_cast<double>(n)));
+  while (r * r > n) {
+    --r;
+  }
+  while (r < numeric_limits<u32>::max() && (r + 1U) * (r + 1U) <= n) {
+    ++r;
+  }
+  return r;
+}
+
+/// Sieves the odd numbers of the half-open interval @c [low, high) one window
+/// at a time. Each window is sized to fit into the cache and the memory
+/// consumption is @c O(sqrt(high)) for the sieving primes.
+///
+/// The multiples of the primes below 17 are removed by copying a precomputed
+/// pattern. All other multiples are struck out with a @c 2*3*5*7 wheel,
+/// skipping every multiple that the pattern removed already.
+/// @code
+/// SegmentedSieve sieve{1'000U, 2'000U};
+/// while (sieve.nextSegment()) {
+///   sieve.forEachPrimeInSegment([](u64 prime) { cout << prime << "\n"; });
+/// }
+/// @endcode
+export class SegmentedSieve {
+public:
+  /// Prepare the sieve for @c [low, high) and compute the necessary sieving
+  /// primes.
+  SegmentedSieve(u64 low, u64 high);
+
+  /// Prepare the sieve for @c [low, high) with precomputed sieving primes.
+  /// @pre @c sievingPrimes contains every prime @c p with @c 17 <= p and
+  /// @c p*p < high in ascending order.
+  /// @sa sievingPrimes
+  SegmentedSieve(u64 low, u64 high, span<const u32> sievingPrimes);
+
+  /// Returns the primes within @c [low, high) that are never reported by
+  /// the segments, because they are part of the presieve pattern.
+  [[nodiscard]] span<const u32> presievedPrimes() const noexcept;
+
+  /// Sieve the next window of the interval.
+  /// @returns @c false if the interval is exhausted.
+  bool nextSegment();
+
+  /// Returns the sieve of the current window. Bit @c i is @c true if
+  /// @c numberAt(i) is prime.
+  [[nodiscard]] const container::BitVector &segment() const noexcept {
+    return _segment;
+  }
+
+  /// Returns the number that is represented by @c bit in the current window.
+  [[nodiscard]] u64 numberAt(usize bit) const noexcept {
+    return 2U * (_segmentBegin + bit) + 1U;
+  }
+
+  /// Calls @c f with every prime of the current window in ascending order.
+  template <invocable<u64> F> void forEachPrimeInSegment(F &&f) const;
+
+private:
+  struct SievingPrime {
+    /// Next multiple that must be struck out.
+    u64 multiple;
+    u32 prime;
+    /// Position within the wheel for the next multiple.
+    u32 wheelIndex;
+  };
+
+  u64 _low;
+  u64 _high;
+  /// Odd-only index of the current window, @c n == 2*index+1.
+  u64 _segmentBegin;
+  /// Odd-only index of the next window.
+  u64 _next;
+  /// Odd-only index that ends the interval.
+  u64 _end;
+  vector<SievingPrime> _primes;
+  container::BitVector _segment;
+};
+
+/// Computes all primes @c p with @c 17 <= p and @c p*p < high. These are
+/// required to sieve any interval below @c high with @c SegmentedSieve.
+export vector<u32> sievingPrimes(u64 high) {
+  auto result = vector<u32>{};
+  if (high <= 1U) {
+    return result;
+  }
+  const u64 limit = isqrt(high - 1U);
+  if (limit < 17U) {
+    return result;
+  }
+  // The sieving primes themselves are found with a segmented sieve, that
+  // recurses until no sieving primes are required anymore.
+  SegmentedSieve sieve{17U, limit + 1U};
+  while (sieve.nextSegment()) {
+    sieve.forEachPrimeInSegment(
+        [&result](u64 prime) { result.push_back(static_cast<u32>(prime)); });
+  }
+  return result;
+}
+
+SegmentedSieve::SegmentedSieve(u64 low, u64 high)
+    : SegmentedSieve(low, high, sievingPrimes(high)) {}
+
+SegmentedSieve::SegmentedSieve(u64 low, u64 high,
+                               span<const u32> sievingPrimes)
+    : _low{low}, _high{max(low, high)}, _segmentBegin{low / 2U},
+      _next{low / 2U}, _end{_high / 2U} {
+  _primes.reserve(sievingPrimes.size());
+  for (const u64 p : sievingPrimes) {
+    if (p < 17U) {
+      continue;
+    }
+    if (p * p >= _high) {
+      break;
+    }
+    // Start with 'p*p', because smaller multiples have a smaller prime factor
+    // and are struck out by it. Then advance to the next factor on the wheel.
+    const u64 firstFactor = max(p, (_low + p - 1U) / p);
+    const auto residue    = static_cast<u32>(firstFactor % wheelModulus);
+    const u64 factor      = firstFactor + wheel.nextOffset[residue];
+    const u64 multiple    = p * factor;
+    if (multiple >= _high) {
+      continue;
+    }
+    _primes.push_back({multiple, static_cast<u32>(p),
+                       u32{wheel.nextIndex[residue]}});
+  }
+}
+
+span<const u32> SegmentedSieve::presievedPrimes() const noexcept {
+  const auto first = ranges::lower_bound(math::presievedPrimes, _low);
+  const auto last  = ranges::lower_bound(math::presievedPrimes, _high);
+  return span{first, last};
+}
+
+bool SegmentedSieve::nextSegment() {
+  if (_next >= _end) {
+    return false;
+  }
+  _segmentBegin      = _next;
+  const usize length = min(segmentLength, static_cast<usize>(_end - _next));
+  _next += length;
+
+  if (_segment.size() != length) {
+    _segment = container::BitVector{length, /*initialValue=*/false};
+  }
+
+  // 1. Copy the presieve pattern word by word, which strikes out the
+  //    multiples of the smallest primes.
+  constexpr usize bitsPerWord = container::BitVector::BitsPerWord;
+  const auto &pattern         = presievePattern();
+  usize offset                = _segmentBegin % presievePeriod;
+  for (auto &word : _segment.words()) {
+    word = pattern.wordAt(offset);
+    offset += bitsPerWord;
+    if (offset >= presievePeriod) {
+      offset -= presievePeriod;
+    }
+  }
+  // The bits beyond the segment must stay cleared.
+  if (length % bitsPerWord != 0U) {
+    _segment.words().back() &= (u64{1U} << (length % bitsPerWord)) - 1U;
+  }
+  // The number 1 is not a prime number.
+  if (_segmentBegin == 0U) {
+    _segment.set(0U, false);
+  }
+
+  // 2. Strike out the multiples of each sieving prime within this window. The
+  //    state of each prime continues in the next window.
+  const u64 numberLimit = 2U * _next;
+  for (auto &sp : _primes) {
+    const u64 p    = sp.prime;
+    u64 multiple   = sp.multiple;
+    u32 wheelIndex = sp.wheelIndex;
+    while (multiple < numberLimit) {
+      _segment.set(static_cast<usize>(multiple / 2U - _segmentBegin), false);
+      multiple += p * wheel.gaps[wheelIndex];
+      wheelIndex = wheelIndex + 1U == wheelSize ? 0U : wheelIndex + 1U;
+    }
+    sp.multiple   = multiple;
+    sp.wheelIndex = wheelIndex;
+  }
+  return true;
+}
+
+template <invocable<u64> F>
+void SegmentedSieve::forEachPrimeInSegment(F &&f) const {
+  for (const usize i : _segment.setBits()) {
+    f(numberAt(i));
+  }
+}
+
+/// Splits @c [low, high) into consecutive chunks that are sieved
+/// independently. Each chunk consists of whole windows and there are a few
+/// chunks per thread, because the work per window is not uniform.
+/// @returns the boundaries of the chunks, starting with @c low and ending
+/// with @c high.
+vector<u64> chunkBoundaries(u64 low, u64 high, usize threads) {
+  constexpr u64 chunksPerThread = 8U;
+  constexpr u64 windowNumbers   = 2U * segmentLength;
+
+  const u64 length     = high - low;
+  const u64 windows    = (length + windowNumbers - 1U) / windowNumbers;
+  const u64 chunkCount = clamp(u64{threads} * chunksPerThread, u64{1U},
+                               max(windows, u64{1U}));
+  const u64 chunkSize =
+      (windows + chunkCount - 1U) / chunkCount * windowNumbers;
+
+  auto boundaries = vector<u64>{low};
+  for (u64 b = low; high - b > chunkSize;) {
+    b += chunkSize;
+    boundaries.push_back(b);
+  }
+  boundaries.push_back(high);
+  return boundaries;
+}
+
+/// Calls @c f with every prime within @c [low, high) in ascending order.
+/// @note Uses O(sqrt(high)) memory, the primes are not materialized.
+export template <invocable<u64> F>
+void forEachPrime(u64 low, u64 high, F &&f) {
+  SegmentedSieve sieve{low, high};
+  for (const u32 prime : sieve.presievedPrimes()) {
+    f(u64{prime});
+  }
+  while (sieve.nextSegment()) {
+    sieve.forEachPrimeInSegment(f);
+  }
+}
+
+/// Input range over all primes within @c [low, high) in ascending order.
+/// The primes are sieved one window at a time while iterating, so the memory
+/// stays at O(sqrt(high)) and the first prime is available immediately.
+/// @note Like @c istream_view, the range is single-pass. @c begin() may only
+/// be called once and the range must not be moved while iterating.
+/// @code
+/// for (const u64 prime : primes(0U, 1'000'000'000U)) {
+///   cout << prime << "\n";
+/// }
+/// @endcode
+export class PrimeRange : public ranges::view_interface<PrimeRange> {
+public:
+  class iterator;
+
+  PrimeRange(u64 low, u64 high) : _sieve{low, high} {}
+
+  [[nodiscard]] iterator begin();
+  [[nodiscard]] default_sentinel_t end() const noexcept {
+    return default_sentinel;
+  }
+
+private:
+  /// Moves to the next prime. Sets @c _exhausted if there is none left.
+  void _advance();
+
+  SegmentedSieve _sieve;
+  /// Number of presieved primes that have been reported.
+  usize _presievedPosition{0U};
+  /// Next bit of the current window that must be inspected.
+  usize _bit{0U};
+  u64 _current{0U};
+  bool _exhausted{false};
+};
+
+class PrimeRange::iterator {
+public:
+  using iterator_concept = input_iterator_tag;
+  using value_type       = u64;
+  using difference_type  = pdiff;
+
+  iterator() = default;
+  explicit iterator(PrimeRange *range) : _range{range} {}
+
+  u64 operator*() const noexcept { return _range->_current; }
+  iterator &operator++() {
+    _range->_advance();
+    return *this;
+  }
+  void operator++(int) { ++*this; }
+
+  friend bool operator==(const iterator &it, default_sentinel_t /*s*/) {
+    return it._isExhausted();
+  }
+
+private:
+  [[nodiscard]] bool _isExhausted() const noexcept {
+    return _range->_exhausted;
+  }
+
+  PrimeRange *_range{nullptr};
+};
+
+PrimeRange::iterator PrimeRange::begin() {
+  _advance();
+  return iterator{this};
+}
+
+void PrimeRange::_advance() {
+  const auto presieved = _sieve.presievedPrimes();
+  if (_presievedPosition < presieved.size()) {
+    _current = presieved[_presievedPosition++];
+    return;
+  }
+
+  while (true) {
+    const auto &segment = _sieve.segment();
+    _bit                = segment.findNext(_bit);
+    if (_bit < segment.size()) {
+      _current = _sieve.numberAt(_bit++);
+      return;
+    }
+    if (!_sieve.nextSegment()) {
+      _exhausted = true;
+      return;
+    }
+    _bit = 0U;
+  }
+}
+
+/// Returns a lazy range over all primes within @c [low, high).
+/// @sa PrimeRange
+export PrimeRange primes(u64 low, u64 high) { return PrimeRange{low, high}; }
+
+/// Computes all primes within @c [low, high) on up to @c threads threads.
+/// The interval is split into chunks of windows, that are sieved
+/// independently and merged in ascending order afterwards.
+/// @returns vector of the prime numbers in ascending order.
+export template <NaturalNumber N>
+vector<N> sieveRange(u64 low, u64 high, usize threads = hardwareThreads()) {
+  if (high <= low) {
+    return {};
+  }
+  const auto primes     = sievingPrimes(high);
+  const auto boundaries = chunkBoundaries(low, high, threads);
+  auto chunkPrimes      = vector<vector<N>>(boundaries.size() - 1U);
+
+  parallelFor(chunkPrimes.size(), threads, [&](usize chunk) {
+    auto &result = chunkPrimes[chunk];
+    SegmentedSieve sieve{boundaries[chunk], boundaries[chunk + 1U], primes};
+    for (const u32 prime : sieve.presievedPrimes()) {
+      result.emplace_back(static_cast<N>(prime));
+    }
+    while (sieve.nextSegment()) {
+      sieve.forEachPrimeInSegment([&result](u64 prime) {
+        result.emplace_back(static_cast<N>(prime));
+      });
+    }
+  });
+
+  auto collectedPrimes = vector<N>{};
+  collectedPrimes.reserve(
+      transform_reduce(chunkPrimes.begin(), chunkPrimes.end(), usize{0U},
+                       plus<>{}, [](const auto &c) { return c.size(); }));
+  for (auto &c : chunkPrimes) {
+    ranges::move(c, back_inserter(collectedPrimes));
+  }
+  return collectedPrimes;
+}
+
+} // namespace jt::math
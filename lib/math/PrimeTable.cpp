@@ -0,0 +1,422 @@
+module;
+
+#include "jt-computing/core/Contracts.hpp"
+
+export module jt.Math:PrimeTable;
+
+import :PrimeSieve;
+
+import std;
+import jt.Core;
+
+using namespace std;
+
+namespace jt::math {
+
+/// Compact storage of an ascending sequence of prime numbers.
+///
+/// The primes are stored as the gaps between consecutive primes, each one
+/// encoded as varint with 7 bits per byte. Below 10^10 almost every gap fits
+/// into a single byte. Every @c sampleRate-th prime is stored verbatim
+/// together with the position of its following gaps. Random access decodes at
+/// most @c sampleRate-1 gaps, iteration decodes one gap per prime.
+///
+/// A table can be written to a file with @c save and reopened with @c load.
+/// A loaded table maps the file into memory and uses it without copying, so
+/// reopening even a large table is instantaneous.
+export class PrimeTable {
+public:
+  class iterator;
+
+  /// Number of primes per sample of the index.
+  static constexpr usize sampleRate = 64U;
+
+  PrimeTable() = default;
+
+  /// Append @c prime to the end of the table.
+  /// @pre empty() || prime > back()
+  void push_back(u64 prime) PRE(empty() || prime > back());
+
+  /// Append all primes within @c [limit(), newLimit) to the table.
+  /// Tables that are loaded from a file are extended as well, e.g. to grow a
+  /// cache on demand.
+  /// @pre empty() || back() < limit()
+  void extend(u64 newLimit, usize threads = 1U)
+      PRE(empty() || back() < limit());
+
+  /// Return the number of primes in the table.
+  [[nodiscard]] usize size() const noexcept { return _size; }
+  [[nodiscard]] bool empty() const noexcept { return _size == 0U; }
+
+  /// Return the bound below which the table contains every prime. Tables
+  /// that are filled with @c push_back return @c 0.
+  [[nodiscard]] u64 limit() const noexcept { return _limit; }
+
+  /// Return the first and the last prime of the table.
+  [[nodiscard]] u64 front() const PRE(!empty()) {
+    return _sampleData()[0].prime;
+  }
+  [[nodiscard]] u64 back() const PRE(!empty()) { return _last; }
+
+  /// Return the prime at position @c index.
+  [[nodiscard]] u64 operator[](usize index) const PRE(index < size());
+
+  /// Return the prime at position @c index.
+  /// @throws out_of_range if @c index >= size()
+  [[nodiscard]] u64 at(usize index) const;
+
+  /// Returns @c true if @c n is stored in the table.
+  [[nodiscard]] bool contains(u64 n) const;
+
+  /// Return the number of bytes used for the encoded primes and the index.
+  [[nodiscard]] usize byteSize() const noexcept {
+    return _gapData().size() + _sampleData().size_bytes();
+  }
+
+  [[nodiscard]] iterator begin() const;
+  [[nodiscard]] iterator end() const;
+
+  /// Write the table to @c path. The file is replaced atomically, a table
+  /// that is currently loaded from @c path stays valid.
+  /// @throws runtime_error if the file can not be written.
+  void save(const filesystem::path &path) const;
+
+  /// Open a table that was written with @c save.
+  /// Only the header of the file is validated, the encoded primes are
+  /// trusted.
+  /// @throws system_error if the file can not be opened.
+  /// @throws runtime_error if the file is not a prime table of this version
+  /// and platform.
+  [[nodiscard]] static PrimeTable load(const filesystem::path &path);
+
+private:
+  struct Sample {
+    u64 prime;
+    /// Position of the gap to the next prime within the gaps.
+    u64 offset;
+  };
+
+  /// Layout of the file. The header is followed by the samples and the gaps.
+  struct FileHeader {
+    array<char, 8> magic;
+    u32 version;
+    u32 byteOrder;
+    u64 sampleRate;
+    u64 size;
+    u64 last;
+    u64 limit;
+    u64 sampleCount;
+    u64 gapBytes;
+  };
+  static constexpr array<char, 8> fileMagic{'J', 'T', 'P', 'R',
+                                            'I', 'M', 'E', 'S'};
+  static constexpr u32 fileVersion   = 1U;
+  static constexpr u32 byteOrderMark = 0x01020304U;
+
+  /// Decode the gap at @c offset and advance @c offset past it.
+  [[nodiscard]] static u64 _decodeGap(span<const u8> gaps, usize &offset);
+
+  [[nodiscard]] span<const Sample> _sampleData() const noexcept {
+    return _file ? _mappedSamples : span<const Sample>{_samples};
+  }
+  [[nodiscard]] span<const u8> _gapData() const noexcept {
+    return _file ? _mappedGaps : span<const u8>{_gaps};
+  }
+
+  /// Copy the data of a loaded table, before it is modified.
+  void _detach();
+
+  vector<Sample> _samples;
+  vector<u8> _gaps;
+  /// A loaded table references the mapped file instead of the vectors.
+  shared_ptr<const MappedFile> _file;
+  span<const Sample> _mappedSamples;
+  span<const u8> _mappedGaps;
+  usize _size{0U};
+  u64 _last{0U};
+  u64 _limit{0U};
+};
+
+/// Forward iterator that decodes the gaps one after another.
+class PrimeTable::iterator {
+public:
+  using iterator_concept  = forward_iterator_tag;
+  using iterator_category = forward_iterator_tag;
+  using value_type        = u64;
+  using difference_type   = pdiff;
+
+  iterator() = default;
+  iterator(const PrimeTable *table, usize index)
+      : _table{table}, _gaps{table->_gapData()}, _index{index} {
+    if (_index < _table->size()) {
+      _loadSample();
+    }
+  }
+
+  u64 operator*() const noexcept { return _prime; }
+
+  iterator &operator++() {
+    if (++_index == _table->size()) {
+      return *this;
+    }
+    if (_index % sampleRate == 0U) {
+      _loadSample();
+    } else {
+      _prime += _decodeGap(_gaps, _offset);
+    }
+    return *this;
+  }
+  iterator operator++(int) {
+    auto before = *this;
+    ++*this;
+    return before;
+  }
+
+  friend bool operator==(const iterator &a, const iterator &b) noexcept {
+    return a._index == b._index;
+  }
+
+private:
+  /// Position on the sample at or before @c _index and decode the remaining
+  /// gaps.
+  void _loadSample() {
+    const auto &sample = _table->_sampleData()[_index / sampleRate];
+    _prime             = sample.prime;
+    _offset            = sample.offset;
+    for (usize i = 0U; i < _index % sampleRate; ++i) {
+      _prime += _decodeGap(_gaps, _offset);
+    }
+  }
+
+  const PrimeTable *_table{nullptr};
+  span<const u8> _gaps;
+  usize _index{0U};
+  usize _offset{0U};
+  u64 _prime{0U};
+};
+
+void PrimeTable::push_back(u64 prime) {
+  _detach();
+  if (_size % sampleRate == 0U) {
+    _samples.push_back({prime, _gaps.size()});
+  } else {
+    u64 gap = prime - _last;
+    while (gap >= 0x80U) {
+      _gaps.push_back(static_cast<u8>(gap | 0x80U));
+      gap >>= 7U;
+    }
+    _gaps.push_back(static_cast<u8>(gap));
+  }
+  _last = prime;
+  ++_size;
+}
+
+u64 PrimeTable::_decodeGap(span<const u8> gaps, usize &offset) {
+  u64 gap    = 0U;
+  u32 shift  = 0U;
+  u8 encoded = 0U;
+  do {
+    encoded = gaps[offset++];
+    gap |= u64{encoded & 0x7FU} << shift;
+    shift += 7U;
+  } while ((encoded & 0x80U) != 0U);
+  return gap;
+}
+
+u64 PrimeTable::operator[](usize index) const {
+  return *iterator{this, index};
+}
+
+u64 PrimeTable::at(usize index) const {
+  if (index >= size()) {
+    throw out_of_range{"Index exceeds the number of primes in the table"};
+  }
+  return (*this)[index];
+}
+
+bool PrimeTable::contains(u64 n) const {
+  // Find the last sample that is not bigger than 'n' and decode the gaps
+  // after it until 'n' is reached or passed.
+  const auto samples = _sampleData();
+  const auto sample  = ranges::upper_bound(samples, n, less{}, &Sample::prime);
+  if (sample == samples.begin()) {
+    return false;
+  }
+  const auto blockIndex = static_cast<usize>(sample - samples.begin()) - 1U;
+  const auto blockEnd   = min(size(), (blockIndex + 1U) * sampleRate);
+
+  u64 prime    = samples[blockIndex].prime;
+  usize offset = samples[blockIndex].offset;
+  usize i      = blockIndex * sampleRate + 1U;
+  while (prime < n && i++ < blockEnd) {
+    prime += _decodeGap(_gapData(), offset);
+  }
+  return prime == n;
+}
+
+PrimeTable::iterator PrimeTable::begin() const { return iterator{this, 0U}; }
+PrimeTable::iterator PrimeTable::end() const { return iterator{this, size()}; }
+
+void PrimeTable::_detach() {
+  if (!_file) {
+    return;
+  }
+  _samples.assign(_mappedSamples.begin(), _mappedSamples.end());
+  _gaps.assign(_mappedGaps.begin(), _mappedGaps.end());
+  _mappedSamples = {};
+  _mappedGaps    = {};
+  _file.reset();
+}
+
+void PrimeTable::save(const filesystem::path &path) const {
+  const auto samples = _sampleData();
+  const auto gaps    = _gapData();
+  const auto header  = FileHeader{
+       .magic       = fileMagic,
+       .version     = fileVersion,
+       .byteOrder   = byteOrderMark,
+       .sampleRate  = sampleRate,
+       .size        = _size,
+       .last        = _last,
+       .limit       = _limit,
+       .sampleCount = samples.size(),
+       .gapBytes    = gaps.size(),
+  };
+
+  // Writing to a temporary file first keeps a mapping of 'path' intact and
+  // never leaves a truncated table behind.
+  auto temporary = path;
+  temporary += ".tmp";
+  {
+    auto out = ofstream{temporary, ios::binary | ios::trunc};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(samples.data()),
+              static_cast<streamsize>(samples.size_bytes()));
+    out.write(reinterpret_cast<const char *>(gaps.data()),
+              static_cast<streamsize>(gaps.size()));
+    if (!out.flush()) {
+      throw runtime_error{"Can not write prime table '" + temporary.string() +
+                          "'"};
+    }
+  }
+  filesystem::rename(temporary, path);
+}
+
+PrimeTable PrimeTable::load(const filesystem::path &path) {
+  auto file        = make_shared<const MappedFile>(path);
+  const auto bytes = file->bytes();
+  const auto error = [&path](string_view reason) {
+    return runtime_error{"'" + path.string() + "' " + string{reason}};
+  };
+
+  FileHeader header{};
+  if (bytes.size() < sizeof(header)) {
+    throw error("is not a prime table");
+  }
+  memcpy(&header, bytes.data(), sizeof(header));
+  if (header.magic != fileMagic) {
+    throw error("is not a prime table");
+  }
+  if (header.version != fileVersion) {
+    throw error("has an unsupported version");
+  }
+  if (header.byteOrder != byteOrderMark || header.sampleRate != sampleRate) {
+    throw error("was written on an incompatible platform");
+  }
+
+  const usize payload = bytes.size() - sizeof(header);
+  const u64 sampleCount =
+      header.size / sampleRate + (header.size % sampleRate != 0U ? 1U : 0U);
+  if (header.sampleCount != sampleCount ||
+      header.sampleCount > payload / sizeof(Sample) ||
+      header.gapBytes != payload - header.sampleCount * sizeof(Sample)) {
+    throw error("is truncated");
+  }
+
+  // The mapping is page aligned and the header a multiple of 8 bytes long,
+  // so the samples are properly aligned.
+  const auto *samples = bytes.data() + sizeof(header);
+  const auto *gaps    = samples + header.sampleCount * sizeof(Sample);
+
+  auto table           = PrimeTable{};
+  table._mappedSamples = span{reinterpret_cast<const Sample *>(samples),
+                              static_cast<usize>(header.sampleCount)};
+  table._mappedGaps    = span{reinterpret_cast<const u8 *>(gaps),
+                           static_cast<usize>(header.gapBytes)};
+  table._file          = std::move(file);
+  table._size          = header.size;
+  table._last          = header.last;
+  table._limit         = header.limit;
+  return table;
+}
+
+/// Returns the sieving primes of @c SegmentedSieve for intervals below
+/// @c high. They are taken from @c table if it covers @c sqrt(high) and are
+/// sieved otherwise.
+/// @sa sievingPrimes(u64)
+export vector<u32> sievingPrimes(const PrimeTable &table, u64 high) {
+  auto result = vector<u32>{};
+  if (high <= 1U) {
+    return result;
+  }
+  for (const u64 prime : table) {
+    if (prime >= table.limit()) {
+      break;
+    }
+    if (prime > (high - 1U) / prime) {
+      return result;
+    }
+    // The primes up to 13 are removed by the presieve pattern.
+    if (prime >= 17U) {
+      result.push_back(static_cast<u32>(prime));
+    }
+  }
+  return sievingPrimes(high);
+}
+
+/// Append all primes within @c [low, high) to @c table.
+void appendPrimes(PrimeTable &table, u64 low, u64 high, usize threads) {
+  if (threads <= 1U) {
+    SegmentedSieve sieve{low, high, sievingPrimes(table, high)};
+    for (const u32 prime : sieve.presievedPrimes()) {
+      table.push_back(prime);
+    }
+    while (sieve.nextSegment()) {
+      sieve.forEachPrimeInSegment(
+          [&table](u64 prime) { table.push_back(prime); });
+    }
+    return;
+  }
+
+  const u64 blockLength = u64{threads} << 26U;
+  while (low < high) {
+    const u64 blockHigh = low + min(blockLength, high - low);
+    for (const u64 prime : sieveRange<u64>(low, blockHigh, threads)) {
+      table.push_back(prime);
+    }
+    low = blockHigh;
+  }
+}
+
+void PrimeTable::extend(u64 newLimit, usize threads) {
+  if (newLimit <= _limit) {
+    return;
+  }
+  appendPrimes(*this, _limit, newLimit, threads);
+  _limit = newLimit;
+}
+
+/// Computes all primes within @c [low, high) directly into a @c PrimeTable.
+/// With more than one thread, the interval is sieved in blocks with
+/// @c sieveRange, that bound the memory of the uncompressed primes.
+export PrimeTable sievePrimeTable(u64 low, u64 high, usize threads = 1U) {
+  auto table = PrimeTable{};
+  if (low <= 2U) {
+    table.extend(high, threads);
+  } else {
+    appendPrimes(table, low, high, threads);
+  }
+  return table;
+}
+
+} // namespace jt::math
@@ -0,0 +1,84 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Container:TestAtomicBitVector;
+
+import std;
+import jt.Container;
+
+using namespace std;
+using namespace jt;
+using namespace jt::container;
+
+TEST_CASE("AtomicBitVector single thread", "") {
+  auto bits = AtomicBitVector{130U};
+  REQUIRE(bits.size() == 130U);
+  REQUIRE(bits.wordCount() == 3U);
+  REQUIRE(bits.count() == 0U);
+
+  REQUIRE_FALSE(bits.testAndSet(64U));
+  REQUIRE(bits.testAndSet(64U));
+  bits.set(129U);
+  REQUIRE(bits.get(64U));
+  REQUIRE(bits.get(129U));
+  REQUIRE_FALSE(bits.get(0U));
+
+  REQUIRE(bits.fetchOr(0U, 0b1010U) == 0U);
+  REQUIRE(bits.fetchOr(0U, 0b0110U) == 0b1010U);
+  REQUIRE(bits.count() == 5U);
+
+  bits.setRange(60U, 70U);
+  bits.setRange(5U, 5U);
+  bits.setStride(100U, 130U, 10U);
+  const auto plain = bits.toBitVector();
+  REQUIRE(plain.size() == 130U);
+  for (usize i = 0U; i < plain.size(); ++i) {
+    const bool expected = (i >= 1U && i <= 3U) || (i >= 60U && i < 70U) ||
+                          i == 100U || i == 110U || i == 120U || i == 129U;
+    REQUIRE(plain.get(i) == expected);
+  }
+  REQUIRE(plain.count() == bits.count());
+
+  const auto copy = AtomicBitVector{plain};
+  REQUIRE(copy.count() == plain.count());
+  REQUIRE(ranges::equal(copy.toBitVector().words(), plain.words()));
+}
+
+TEST_CASE("AtomicBitVector concurrent marking", "") {
+  const usize threads = max(usize{4U}, hardwareThreads());
+
+  SECTION("testAndSet claims every bit once") {
+    constexpr usize size = 10'000U;
+    auto bits            = AtomicBitVector{size};
+    auto claimed         = atomic<usize>{0U};
+    // Every thread tries to claim all bits.
+    parallelFor(threads, threads, [&](usize) {
+      for (usize i = 0U; i < size; ++i) {
+        if (!bits.testAndSet(i)) {
+          claimed.fetch_add(1U, memory_order_relaxed);
+        }
+      }
+    });
+    REQUIRE(claimed.load() == size);
+    REQUIRE(bits.count() == size);
+  }
+
+  SECTION("Overlapping strides sieve the composites") {
+    constexpr usize limit = 100'000U;
+    auto composite        = AtomicBitVector{limit};
+    parallelFor(limit / 2U, threads, [&](usize i) {
+      const usize p = i + 2U;
+      if (p * p < limit) {
+        composite.setStride(p * p, limit, p);
+      }
+    });
+    const auto sieve = composite.toBitVector();
+
+    usize primes = 0U;
+    for (usize n = 2U; n < limit; ++n) {
+      primes += sieve.get(n) ? 0U : 1U;
+    }
+    REQUIRE(primes == 9'592U);
+  }
+}
@@ -14,7 +14,8 @@ using namespace jt::container;
 TEST_CASE("BitVector Construction", "") {
   SECTION("Default Construction") {
     BitVector b;
-    REQUIRE(b.capacity() == 0);
+    // Small vectors are stored inline.
+    REQUIRE(b.capacity() == 128);
     REQUIRE(b.size() == 0);
   }
 
@@ -33,7 +34,7 @@ TEST_CASE("BitVector Construction", "") {
   SECTION("With unsigned 8bit integer") {
     SECTION("All 0") {
       BitVector b{u8{0}};
-      REQUIRE(b.capacity() == 8ULL);
+      REQUIRE(b.capacity() == 128ULL);
       REQUIRE(b.size() == 8ULL);
       for (usize i = 0; i < 8; ++i) {
         REQUIRE(b.get(i) == false);
@@ -42,7 +43,7 @@ TEST_CASE("BitVector Construction", "") {
 
     SECTION("All 1") {
       BitVector b{numeric_limits<u8>::max()};
-      REQUIRE(b.capacity() == 8ULL);
+      REQUIRE(b.capacity() == 128ULL);
       REQUIRE(b.size() == 8ULL);
       for (usize i = 0; i < 8; ++i) {
         REQUIRE(b.get(i) == true);
@@ -51,7 +52,7 @@ TEST_CASE("BitVector Construction", "") {
 
     SECTION("First half 0, second 1") {
       BitVector b{u8{240}};
-      REQUIRE(b.capacity() == 8ULL);
+      REQUIRE(b.capacity() == 128ULL);
       REQUIRE(b.size() == 8ULL);
       usize i = 0;
       for (i = 0; i < 4; ++i) {
@@ -64,7 +65,7 @@ TEST_CASE("BitVector Construction", "") {
 
     SECTION("First half 1, second 0") {
       BitVector b{u8{15}};
-      REQUIRE(b.capacity() == 8ULL);
+      REQUIRE(b.capacity() == 128ULL);
       REQUIRE(b.size() == 8ULL);
       usize i = 0;
       for (i = 0; i < 4; ++i) {
@@ -148,3 +149,243 @@ TEST_CASE("BitVector right shifting", "") {
   b.normalize();
   REQUIRE(b.size() == 3);
 }
+
+TEST_CASE("BitVector across word boundaries", "") {
+  SECTION("Construction from wide integers") {
+    BitVector b{u64{1U} << 63U};
+    REQUIRE(b.size() == 64U);
+    REQUIRE(b.get(63) == true);
+    REQUIRE(b.get(62) == false);
+    b.normalize();
+    REQUIRE(b.size() == 64U);
+  }
+
+  SECTION("Appending into the next word") {
+    BitVector b{63ULL, true};
+    b.push_back(false);
+    b.push_back(true);
+    REQUIRE(b.size() == 65U);
+    REQUIRE(b.get(62) == true);
+    REQUIRE(b.get(63) == false);
+    REQUIRE(b.get(64) == true);
+  }
+
+  SECTION("Normalization drops whole words") {
+    BitVector b{200ULL, false};
+    b.set(70, true);
+    b.normalize();
+    REQUIRE(b.size() == 71U);
+
+    BitVector zeros{130ULL, false};
+    zeros.normalize();
+    REQUIRE(zeros.size() == 0U);
+  }
+
+  SECTION("Shifting by more than a word") {
+    BitVector b{u8{5}};
+    b <<= 100;
+    REQUIRE(b.size() == 108U);
+    REQUIRE(b.get(100) == true);
+    REQUIRE(b.get(101) == false);
+    REQUIRE(b.get(102) == true);
+    b.normalize();
+    REQUIRE(b.size() == 103U);
+
+    b >>= 101;
+    REQUIRE(b.size() == 2U);
+    REQUIRE(b.get(0) == false);
+    REQUIRE(b.get(1) == true);
+  }
+}
+
+TEST_CASE("BitVector bulk operations", "") {
+  // Bits that are set at every third and every fifth position respectively.
+  BitVector threes{300ULL, false};
+  BitVector fives{300ULL, false};
+  for (usize i = 0U; i < 300U; ++i) {
+    threes.set(i, i % 3U == 0U);
+    fives.set(i, i % 5U == 0U);
+  }
+
+  SECTION("Counting") {
+    REQUIRE(threes.count() == 100U);
+    REQUIRE(fives.count() == 60U);
+    REQUIRE(BitVector{}.count() == 0U);
+  }
+  SECTION("Combining") {
+    REQUIRE((threes & fives).count() == 20U);
+    REQUIRE((threes | fives).count() == 140U);
+    REQUIRE((threes ^ fives).count() == 120U);
+    REQUIRE((~threes).count() == 200U);
+    REQUIRE((~threes).size() == 300U);
+
+    auto both = threes;
+    both &= fives;
+    for (usize i = 0U; i < 300U; ++i) {
+      REQUIRE(both.get(i) == (i % 15U == 0U));
+    }
+  }
+  SECTION("Flipping keeps the size") {
+    BitVector b{70ULL, false};
+    b.flip();
+    REQUIRE(b.count() == 70U);
+    b.normalize();
+    REQUIRE(b.size() == 70U);
+  }
+  SECTION("Filling ranges") {
+    BitVector b{300ULL, false};
+    b.fill(10U, 20U, true);
+    REQUIRE(b.count() == 10U);
+    b.fill(60U, 250U, true);
+    REQUIRE(b.count() == 200U);
+    REQUIRE(b.get(59) == false);
+    REQUIRE(b.get(60) == true);
+    REQUIRE(b.get(249) == true);
+    REQUIRE(b.get(250) == false);
+    b.fill(64U, 128U, false);
+    REQUIRE(b.count() == 136U);
+    b.fill(0U, 300U, true);
+    REQUIRE(b.count() == 300U);
+    b.fill(5U, 5U, false);
+    REQUIRE(b.count() == 300U);
+  }
+  SECTION("Finding set bits") {
+    REQUIRE(fives.findFirst() == 0U);
+    REQUIRE(fives.findNext(1U) == 5U);
+    REQUIRE(fives.findNext(5U) == 5U);
+    REQUIRE(fives.findNext(296U) == 300U);
+    REQUIRE(BitVector{200ULL, false}.findFirst() == 200U);
+
+    BitVector b{200ULL, false};
+    b.set(199, true);
+    REQUIRE(b.findNext(3U) == 199U);
+  }
+  SECTION("Iterating set bits") {
+    static_assert(ranges::forward_range<decltype(fives.setBits())>);
+    const auto both = threes & fives;
+    auto indices    = vector<usize>{};
+    for (const usize i : both.setBits()) {
+      indices.push_back(i);
+    }
+    REQUIRE(indices.size() == 20U);
+    REQUIRE(indices.front() == 0U);
+    REQUIRE(indices.back() == 285U);
+    REQUIRE(ranges::distance(BitVector{100ULL, false}.setBits()) == 0);
+  }
+  SECTION("Reading words at any offset") {
+    REQUIRE(fives.wordAt(0U) == fives.words()[0]);
+    const auto word = fives.wordAt(3U);
+    for (usize i = 0U; i < BitVector::BitsPerWord; ++i) {
+      REQUIRE(((word >> i) & 1U) == (fives.get(3U + i) ? 1U : 0U));
+    }
+    REQUIRE(fives.wordAt(290U) == 0b100001U);
+  }
+}
+
+TEST_CASE("BitVector shifting matches bitwise shifting", "") {
+  // A pseudo random pattern, that is shifted by every distance around the
+  // word boundaries and compared to a shift bit by bit.
+  BitVector pattern{250ULL, false};
+  for (usize i = 0U; i < pattern.size(); ++i) {
+    pattern.set(i, (i * 2'654'435'761U) % 7U < 3U);
+  }
+
+  for (const int shift : {1, 5, 63, 64, 65, 127, 128, 129, 200, 249}) {
+    auto left = pattern;
+    left <<= shift;
+    REQUIRE(left.size() == pattern.size() + usize(shift));
+    REQUIRE(left.count() == pattern.count());
+    for (usize i = 0U; i < pattern.size(); ++i) {
+      REQUIRE(left.get(i + usize(shift)) == pattern.get(i));
+    }
+    REQUIRE(left.findFirst() >= usize(shift));
+
+    auto right = pattern;
+    right >>= shift;
+    REQUIRE(right.size() == pattern.size() - usize(shift));
+    for (usize i = 0U; i < right.size(); ++i) {
+      REQUIRE(right.get(i) == pattern.get(i + usize(shift)));
+    }
+
+    left >>= shift;
+    REQUIRE(left.size() == pattern.size());
+    REQUIRE(((left ^ pattern).count()) == 0U);
+  }
+
+  SECTION("Copies and moves of large vectors") {
+    auto copy = pattern;
+    REQUIRE((copy ^ pattern).count() == 0U);
+    const auto *data = copy.words().data();
+    auto moved       = std::move(copy);
+    REQUIRE(moved.words().data() == data);
+    copy = moved;
+    REQUIRE((copy ^ pattern).count() == 0U);
+    REQUIRE(copy.words().data() != data);
+  }
+
+  SECTION("Shifts do not reallocate within the capacity") {
+    auto b = pattern;
+    b >>= 100;
+    const auto *data = b.words().data();
+    b <<= 100;
+    REQUIRE(b.words().data() == data);
+  }
+}
+
+TEST_CASE("BitVector inline storage", "") {
+  SECTION("Small vectors live within the object") {
+    BitVector b{u64{0xF0F0U}};
+    const auto *data = b.words().data();
+    REQUIRE(static_cast<const void *>(data) >= static_cast<const void *>(&b));
+    REQUIRE(static_cast<const void *>(data) <
+            static_cast<const void *>(&b + 1));
+    b.push_back(true);
+    REQUIRE(b.size() == 65U);
+    REQUIRE(b.words().data() == data);
+  }
+
+  SECTION("Growing beyond the inline storage keeps the bits") {
+    BitVector b{u64{0xF0F0U}};
+    for (usize i = 0U; i < 200U; ++i) {
+      b.push_back(i % 2U == 0U);
+    }
+    REQUIRE(b.size() == 264U);
+    REQUIRE(b.capacity() >= 264U);
+    REQUIRE(b.wordAt(0U) == 0xF0F0U);
+    REQUIRE(b.count() == 8U + 100U);
+
+    // Moving between inline and allocated vectors in both directions.
+    BitVector small{u8{3}};
+    swap(small, b);
+    REQUIRE(small.size() == 264U);
+    REQUIRE(b.size() == 8U);
+    REQUIRE(b.count() == 2U);
+    b = small;
+    REQUIRE(b.count() == 108U);
+    small = BitVector{u8{1}};
+    REQUIRE(small.size() == 8U);
+    REQUIRE(small.count() == 1U);
+  }
+
+  SECTION("Moved-from vectors are empty and usable") {
+    for (const usize bits : {100U, 300U}) {
+      INFO(bits << " bits");
+      auto b     = BitVector{bits, true};
+      auto moved = std::move(b);
+      REQUIRE(moved.count() == bits);
+      // NOLINTNEXTLINE(bugprone-use-after-move)
+      REQUIRE(b.size() == 0U);
+      REQUIRE(b.count() == 0U);
+      b.push_back(true);
+      REQUIRE(b.size() == 1U);
+      REQUIRE(b.get(0U));
+
+      b = std::move(moved);
+      REQUIRE(b.count() == bits);
+      // NOLINTNEXTLINE(bugprone-use-after-move)
+      REQUIRE(moved.size() == 0U);
+      moved.resize(70U);
+      REQUIRE(moved.count() == 0U);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Container:TestRankSelect;
+
+import std;
+import jt.Container;
+
+using namespace std;
+using namespace jt;
+using namespace jt::container;
+
+namespace {
+/// Compares every rank and select query against a linear scan.
+void requireMatchesScan(const BitVector &bits) {
+  const auto index = RankSelectIndex{bits};
+  usize ones       = 0U;
+  for (usize i = 0U; i < bits.size(); ++i) {
+    REQUIRE(index.rank(i) == ones);
+    if (bits.get(i)) {
+      REQUIRE(index.select(ones) == i);
+      ++ones;
+    }
+  }
+  REQUIRE(index.rank(bits.size()) == ones);
+  REQUIRE(index.count() == ones);
+}
+} // namespace
+
+TEST_CASE("RankSelectIndex on small vectors", "") {
+  SECTION("Empty") {
+    const BitVector bits;
+    const auto index = RankSelectIndex{bits};
+    REQUIRE(index.count() == 0U);
+    REQUIRE(index.rank(0U) == 0U);
+  }
+  SECTION("All cleared") { requireMatchesScan(BitVector{1'000ULL, false}); }
+  SECTION("All set") { requireMatchesScan(BitVector{1'000ULL, true}); }
+  SECTION("Single bit") {
+    BitVector bits{5'000ULL, false};
+    bits.set(4'321U, true);
+    requireMatchesScan(bits);
+  }
+}
+
+TEST_CASE("RankSelectIndex across many superblocks", "") {
+  // Dense and sparse regions, so that superblocks and select samples are
+  // skipped and empty blocks occur.
+  BitVector bits{300'000ULL, false};
+  for (usize i = 0U; i < bits.size(); ++i) {
+    const bool dense = (i / 50'000U) % 2U == 0U;
+    bits.set(i, dense ? (i * 7U) % 3U != 0U : i % 9'973U == 0U);
+  }
+  requireMatchesScan(bits);
+
+  const auto index = RankSelectIndex{bits};
+  REQUIRE(index.byteSize() * 20U < bits.words().size_bytes());
+}
+
+TEST_CASE("RankSelectIndex counts primes", "") {
+  // Bit i of the sieve segment represents the odd number 2*i+1.
+  BitVector odds{500'000ULL, true};
+  odds.set(0U, false);
+  for (usize i = 1U; 2U * i + 1U < 1'000U; ++i) {
+    if (odds.get(i)) {
+      for (usize m = (2U * i + 1U) * (2U * i + 1U) / 2U; m < odds.size();
+           m += 2U * i + 1U) {
+        odds.set(m, false);
+      }
+    }
+  }
+  const auto index = RankSelectIndex{odds};
+  // pi(10^6) without the prime 2.
+  REQUIRE(index.count() == 78'498U - 1U);
+  // pi(1000) - 1
+  REQUIRE(index.rank(500U) == 167U);
+  // The 10000th prime is 104729, the 9999th odd prime.
+  REQUIRE(2U * index.select(9'998U) + 1U == 104'729U);
+}
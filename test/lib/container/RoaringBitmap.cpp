@@ -0,0 +1,199 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Container:TestRoaringBitmap;
+
+import std;
+import jt.Container;
+
+using namespace std;
+using namespace jt;
+using namespace jt::container;
+
+namespace {
+vector<u32> values(const RoaringBitmap &bitmap) {
+  auto result = vector<u32>{};
+  bitmap.forEach([&result](u32 value) { result.push_back(value); });
+  return result;
+}
+
+/// Builds both a sorted reference set and the bitmap of @c count values
+/// from a fixed pseudo random sequence below @c limit.
+pair<set<u32>, RoaringBitmap> randomSet(usize count, u32 limit, u32 seed) {
+  auto generator = minstd_rand{seed};
+  auto reference = set<u32>{};
+  auto bitmap    = RoaringBitmap{};
+  for (usize i = 0U; i < count; ++i) {
+    const auto value = static_cast<u32>(generator() % limit);
+    reference.insert(value);
+    bitmap.add(value);
+  }
+  return {reference, bitmap};
+}
+} // namespace
+
+TEST_CASE("RoaringBitmap add, remove and contains", "") {
+  auto bitmap = RoaringBitmap{};
+  REQUIRE(bitmap.empty());
+  REQUIRE(bitmap.count() == 0U);
+
+  bitmap.add(5U);
+  bitmap.add(70'000U);
+  bitmap.add(5U);
+  bitmap.add(numeric_limits<u32>::max());
+  REQUIRE(bitmap.count() == 3U);
+  REQUIRE(bitmap.contains(5U));
+  REQUIRE(bitmap.contains(70'000U));
+  REQUIRE(bitmap.contains(numeric_limits<u32>::max()));
+  REQUIRE_FALSE(bitmap.contains(6U));
+  REQUIRE_FALSE(bitmap.contains(70'000U - 65'536U));
+  REQUIRE(values(bitmap) ==
+          vector<u32>{5U, 70'000U, numeric_limits<u32>::max()});
+
+  bitmap.remove(70'000U);
+  bitmap.remove(6U);
+  REQUIRE(bitmap.count() == 2U);
+  REQUIRE_FALSE(bitmap.contains(70'000U));
+
+  bitmap.remove(5U);
+  bitmap.remove(numeric_limits<u32>::max());
+  REQUIRE(bitmap.empty());
+}
+
+TEST_CASE("RoaringBitmap switches between array and bitmap chunks", "") {
+  auto bitmap = RoaringBitmap{};
+  for (u32 value = 0U; value < 20'000U; value += 2U) {
+    bitmap.add(value);
+  }
+  REQUIRE(bitmap.count() == 10'000U);
+  // 10000 values stored as 16 bit array would take 20000 bytes.
+  REQUIRE(bitmap.byteSize() < 10'000U);
+  REQUIRE(bitmap.contains(19'998U));
+  REQUIRE_FALSE(bitmap.contains(19'999U));
+  // Values, that are already in the set or not in it, keep the count.
+  bitmap.add(0U);
+  bitmap.remove(1U);
+  REQUIRE(bitmap.count() == 10'000U);
+
+  for (u32 value = 0U; value < 19'000U; value += 2U) {
+    bitmap.remove(value);
+  }
+  REQUIRE(bitmap.count() == 500U);
+  REQUIRE(bitmap.byteSize() < 2'000U);
+  REQUIRE(values(bitmap).front() == 19'000U);
+}
+
+TEST_CASE("RoaringBitmap run optimization", "") {
+  auto bitmap = RoaringBitmap{};
+  for (u32 value = 100U; value < 60'000U; ++value) {
+    bitmap.add(value);
+  }
+  const auto before = bitmap;
+  bitmap.runOptimize();
+  REQUIRE(bitmap.byteSize() < 100U);
+  REQUIRE(bitmap == before);
+  REQUIRE(bitmap.count() == 59'900U);
+  REQUIRE(bitmap.contains(100U));
+  REQUIRE(bitmap.contains(59'999U));
+  REQUIRE_FALSE(bitmap.contains(99U));
+  REQUIRE_FALSE(bitmap.contains(60'000U));
+
+  // Modifying a run chunk converts it back.
+  bitmap.remove(1'000U);
+  bitmap.add(60'001U);
+  REQUIRE(bitmap.count() == 59'900U);
+  REQUIRE_FALSE(bitmap.contains(1'000U));
+  REQUIRE(bitmap.contains(60'001U));
+}
+
+TEST_CASE("RoaringBitmap union and intersection", "") {
+  SECTION("Random sets") {
+    for (const u32 limit : {1'000U, 200'000U, 10'000'000U}) {
+      const auto [referenceA, a] = randomSet(30'000U, limit, 1U);
+      const auto [referenceB, b] = randomSet(20'000U, limit, 2U);
+
+      auto united = vector<u32>{};
+      ranges::set_union(referenceA, referenceB, back_inserter(united));
+      REQUIRE(values(a | b) == united);
+
+      auto common = vector<u32>{};
+      ranges::set_intersection(referenceA, referenceB, back_inserter(common));
+      REQUIRE(values(a & b) == common);
+    }
+  }
+  SECTION("Runs with arrays and bitmaps") {
+    auto runs = RoaringBitmap{};
+    for (u32 value = 0U; value < 200'000U; ++value) {
+      if (value % 1'000U < 500U) {
+        runs.add(value);
+      }
+    }
+    runs.runOptimize();
+    auto otherRuns = RoaringBitmap{};
+    for (u32 value = 250U; value < 150'000U; ++value) {
+      if (value % 1'000U < 750U) {
+        otherRuns.add(value);
+      }
+    }
+    otherRuns.runOptimize();
+    const auto [reference, random] = randomSet(50'000U, 300'000U, 3U);
+
+    for (const auto *other : {&as_const(otherRuns), &random}) {
+      const auto united = runs | *other;
+      const auto common = runs & *other;
+      REQUIRE(united == (*other | runs));
+      REQUIRE(common == (*other & runs));
+      for (u32 value = 0U; value < 300'000U; ++value) {
+        const bool inRuns  = runs.contains(value);
+        const bool inOther = other->contains(value);
+        REQUIRE(united.contains(value) == (inRuns || inOther));
+        REQUIRE(common.contains(value) == (inRuns && inOther));
+      }
+    }
+    REQUIRE(reference.size() == random.count());
+  }
+  SECTION("Disjoint chunks") {
+    auto a = RoaringBitmap{};
+    auto b = RoaringBitmap{};
+    a.add(1U);
+    b.add(100'000U);
+    REQUIRE((a & b).empty());
+    REQUIRE(values(a | b) == vector<u32>{1U, 100'000U});
+  }
+}
+
+TEST_CASE("RoaringBitmap and BitVector", "") {
+  auto bits = BitVector{300'000ULL, false};
+  for (usize i = 70'000U; i < 140'000U; ++i) {
+    bits.set(i, true);
+  }
+  for (usize i = 200'000U; i < 300'000U; i += 97U) {
+    bits.set(i, true);
+  }
+  bits.set(0U, true);
+
+  const auto bitmap = RoaringBitmap{bits};
+  REQUIRE(bitmap.count() == bits.count());
+  // The dense run compresses far below the 37500 bytes of the bits.
+  REQUIRE(bitmap.byteSize() < 4'000U);
+  for (usize i = 0U; i < bits.size(); ++i) {
+    REQUIRE(bitmap.contains(static_cast<u32>(i)) == bits.get(i));
+  }
+  const auto converted = bitmap.toBitVector(bits.size());
+  REQUIRE(converted.size() == bits.size());
+  REQUIRE(ranges::equal(converted.words(), bits.words()));
+
+  auto dense = RoaringBitmap{};
+  for (u32 value = 65'536U; value < 2U * 65'536U; value += 3U) {
+    dense.add(value);
+  }
+  const auto truncated = dense.toBitVector(100'000U);
+  REQUIRE(truncated.size() == 100'000U);
+  for (usize i = 0U; i < truncated.size(); ++i) {
+    REQUIRE(truncated.get(i) == (i >= 65'536U && (i - 65'536U) % 3U == 0U));
+  }
+  const auto full = dense.toBitVector(3U * 65'536U);
+  REQUIRE(RoaringBitmap{full} == dense);
+  REQUIRE(RoaringBitmap{BitVector{}}.empty());
+}
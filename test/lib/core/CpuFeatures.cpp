@@ -0,0 +1,82 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Core:TestCpuFeatures;
+
+import std;
+import jt.Core;
+
+using namespace std;
+using namespace jt;
+
+namespace {
+int portable() { return 0; }
+int vectorized() { return 1; }
+int bitManipulation() { return 2; }
+} // namespace
+
+TEST_CASE("CpuFeatureSet operations", "") {
+  const auto set = CpuFeatureSet{CpuFeature::BMI2, CpuFeature::ADX};
+  REQUIRE(set.has(CpuFeature::BMI2));
+  REQUIRE_FALSE(set.has(CpuFeature::AVX2));
+  REQUIRE(set.contains(CpuFeatureSet{CpuFeature::ADX}));
+  REQUIRE(set.contains(CpuFeatureSet{}));
+  REQUIRE_FALSE(set.contains(CpuFeatureSet{CpuFeature::ADX, CpuFeature::SHA}));
+  REQUIRE(set.without(CpuFeatureSet{CpuFeature::ADX}) ==
+          CpuFeatureSet{CpuFeature::BMI2});
+  REQUIRE(CpuFeatureSet::all().contains(set));
+  REQUIRE(CpuFeatureSet::all().without(CpuFeatureSet::all()).empty());
+}
+
+TEST_CASE("CpuFeatureSet parsing", "") {
+  REQUIRE(CpuFeatureSet::parse("").empty());
+  REQUIRE(CpuFeatureSet::parse("bmi2, adx,") ==
+          CpuFeatureSet{CpuFeature::BMI2, CpuFeature::ADX});
+  REQUIRE(CpuFeatureSet::parse("sha,all") == CpuFeatureSet::all());
+  REQUIRE_THROWS_AS(CpuFeatureSet::parse("avx3"), invalid_argument);
+  REQUIRE_THROWS_AS(CpuFeatureSet::parse("sha,avx3"), invalid_argument);
+
+  // The environment variable of the host features skips unknown names one at
+  // a time, so a typo does not enable the features next to it.
+  const auto disabled = CpuFeatureSet::parseKnown("sha, avx3 ,adx");
+  REQUIRE(disabled == CpuFeatureSet{CpuFeature::SHA, CpuFeature::ADX});
+  REQUIRE_FALSE(CpuFeatureSet::all().without(disabled).has(CpuFeature::SHA));
+  REQUIRE(CpuFeatureSet::parseKnown("avx3,all") == CpuFeatureSet::all());
+
+  for (const auto feature :
+       {CpuFeature::SSSE3, CpuFeature::SSE41, CpuFeature::AVX,
+        CpuFeature::AVX2, CpuFeature::BMI2, CpuFeature::ADX,
+        CpuFeature::AVX512F, CpuFeature::SHA}) {
+    REQUIRE(CpuFeatureSet::parse(cpuFeatureName(feature)) ==
+            CpuFeatureSet{feature});
+  }
+}
+
+TEST_CASE("CpuFeatureSet host", "") {
+  // The override can only remove features.
+  REQUIRE(CpuFeatureSet::detect().contains(CpuFeatureSet::host()));
+  REQUIRE(&CpuFeatureSet::host() == &CpuFeatureSet::host());
+  if (CpuFeatureSet::host().has(CpuFeature::AVX2)) {
+    REQUIRE(CpuFeatureSet::host().has(CpuFeature::AVX));
+  }
+}
+
+TEST_CASE("Select implementation", "") {
+  using Function             = int();
+  const auto implementations = array{
+      Implementation<Function>{"bmi2", {CpuFeature::BMI2}, &bitManipulation},
+      Implementation<Function>{"avx2", {CpuFeature::AVX2}, &vectorized},
+      Implementation<Function>{"portable", {}, &portable},
+  };
+  const auto select = [&](CpuFeatureSet available) {
+    return selectImplementation(span{implementations}, available).function();
+  };
+  REQUIRE(select(CpuFeatureSet::all()) == 2);
+  REQUIRE(select({CpuFeature::AVX2, CpuFeature::ADX}) == 1);
+  REQUIRE(select({}) == 0);
+
+  const auto noFallback = span{implementations}.first(2U);
+  REQUIRE_THROWS_AS(selectImplementation(noFallback, CpuFeatureSet{}),
+                    logic_error);
+}
@@ -0,0 +1,130 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Core:TestMappedFile;
+
+import std;
+import jt.Core;
+
+using namespace std;
+using namespace jt;
+
+namespace {
+/// Return a path in the temporary directory, that no concurrent test run
+/// uses.
+filesystem::path uniqueTemporaryPath(string_view name) {
+  auto device = random_device{};
+  return filesystem::temp_directory_path() /
+         (string{name} + "-" + to_string(device()));
+}
+
+string asString(span<const byte> bytes) {
+  return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
+
+string readAll(FileReader &reader) {
+  auto content = string{};
+  for (auto chunk = reader.next(); !chunk.empty(); chunk = reader.next()) {
+    content += asString(chunk);
+  }
+  return content;
+}
+} // namespace
+
+TEST_CASE("MappedFile", "") {
+  const auto directory = uniqueTemporaryPath("jt-computing-mapped-file");
+  const auto path      = directory / "content.txt";
+  const auto content   = string(10'000U, 'm') + "end";
+  filesystem::create_directories(directory);
+  {
+    auto out = ofstream{path, ios::binary | ios::trunc};
+    out << content;
+  }
+
+  SECTION("Content of the file with every access advice") {
+    for (const auto access :
+         {FileAccess::Normal, FileAccess::Sequential, FileAccess::Random}) {
+      const auto file = MappedFile{path, access};
+      REQUIRE(file.size() == content.size());
+      REQUIRE(asString(file.bytes()) == content);
+    }
+  }
+  SECTION("Moving transfers the mapping") {
+    auto file  = MappedFile{path};
+    auto moved = std::move(file);
+    REQUIRE(asString(moved.bytes()) == content);
+    // NOLINTNEXTLINE(bugprone-use-after-move)
+    REQUIRE(file.bytes().empty());
+
+    file = std::move(moved);
+    REQUIRE(asString(file.bytes()) == content);
+  }
+  SECTION("Empty files") {
+    { auto out = ofstream{path, ios::binary | ios::trunc}; }
+    const auto file = MappedFile{path};
+    REQUIRE(file.size() == 0U);
+    REQUIRE(file.bytes().empty());
+  }
+  SECTION("Missing files can not be opened") {
+    REQUIRE_THROWS_AS(MappedFile{directory / "missing"}, system_error);
+  }
+  SECTION("Directories can be opened, but not mapped") {
+    REQUIRE_THROWS_AS(MappedFile{directory}, system_error);
+  }
+  filesystem::remove_all(directory);
+}
+
+TEST_CASE("FileReader", "") {
+  const auto path    = uniqueTemporaryPath("jt-computing-file-reader");
+  const auto content = string(100'000U, 'r') + "end";
+  {
+    auto out = ofstream{path, ios::binary | ios::trunc};
+    out << content;
+  }
+
+  SECTION("Regular files are read as one chunk") {
+    auto reader = FileReader{path, 16U};
+    REQUIRE(reader.next().size() == content.size());
+    REQUIRE(reader.next().empty());
+
+    auto again = FileReader{path};
+    REQUIRE(readAll(again) == content);
+  }
+  SECTION("Reading into buffers of the caller") {
+    auto reader = FileReader{path};
+    auto buffer = vector<byte>(30'000U);
+    auto result = string{};
+    for (auto count = reader.read(buffer); count > 0U;
+         count      = reader.read(buffer)) {
+      result += asString(span{buffer}.first(count));
+    }
+    REQUIRE(result == content);
+
+    auto device = FileReader{"/dev/zero"};
+    REQUIRE(device.read(buffer) == buffer.size());
+  }
+  SECTION("Reading continues where the other way stopped") {
+    auto reader = FileReader{path};
+    auto buffer = vector<byte>(1'000U);
+    REQUIRE(reader.read(buffer) == buffer.size());
+    REQUIRE(asString(buffer) + asString(reader.next()) == content);
+    REQUIRE(reader.read(buffer) == 0U);
+    REQUIRE(reader.next().empty());
+  }
+  SECTION("Empty files") {
+    { auto out = ofstream{path, ios::binary | ios::trunc}; }
+    auto reader = FileReader{path};
+    REQUIRE(readAll(reader).empty());
+  }
+  SECTION("Devices are read with the buffer") {
+    auto reader = FileReader{"/dev/zero", 10U};
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(asString(reader.next()) == string(10U, '\0'));
+    }
+  }
+  SECTION("Missing files") {
+    REQUIRE_THROWS_AS(FileReader{path / "missing"}, system_error);
+  }
+  filesystem::remove(path);
+}
@@ -0,0 +1,106 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Core:TestParallel;
+
+import std;
+import jt.Core;
+
+using namespace std;
+using namespace jt;
+
+TEST_CASE("parallelFor visits every index once", "") {
+  REQUIRE(hardwareThreads() >= 1U);
+  for (const usize threads : {1U, 4U}) {
+    INFO(threads << " threads");
+    auto visited = vector<atomic<int>>(1'000U);
+    parallelFor(visited.size(), threads, [&](usize i) { ++visited[i]; });
+    REQUIRE(
+        ranges::all_of(visited, [](const atomic<int> &v) { return v == 1; }));
+  }
+  // No work, no calls.
+  parallelFor(0U, 4U, [](usize) { throw logic_error{"Not called"}; });
+}
+
+TEST_CASE("parallelFor rethrows the first exception", "") {
+  for (const usize threads : {1U, 4U}) {
+    INFO(threads << " threads");
+    auto started = atomic<usize>{0U};
+    REQUIRE_THROWS_AS(parallelFor(100'000U, threads,
+                                  [&](usize i) {
+                                    ++started;
+                                    if (i == 10U) {
+                                      throw runtime_error{"Failed"};
+                                    }
+                                  }),
+                      runtime_error);
+    // No further indices are started after the exception.
+    REQUIRE(started < 100'000U);
+  }
+}
+
+TEST_CASE("BoundedQueue between threads", "") {
+  SECTION("Items arrive in order and the queue drains after closing") {
+    auto queue    = BoundedQueue<int>{3U};
+    auto received = vector<int>{};
+    {
+      auto consumer = jthread{[&] {
+        while (auto item = queue.pop()) {
+          received.push_back(*item);
+        }
+      }};
+      for (int i = 0; i < 100; ++i) {
+        REQUIRE(queue.push(i));
+      }
+      queue.close();
+    }
+    REQUIRE(ranges::equal(received, views::iota(0, 100)));
+    REQUIRE_FALSE(queue.push(100));
+    REQUIRE_FALSE(queue.pop().has_value());
+  }
+  SECTION("Many producers and consumers") {
+    auto queue = BoundedQueue<int>{2U};
+    auto sum   = atomic<int>{0};
+    {
+      auto consumers = vector<jthread>{};
+      for (int c = 0; c < 3; ++c) {
+        consumers.emplace_back([&] {
+          while (auto item = queue.pop()) {
+            sum += *item;
+          }
+        });
+      }
+      parallelFor(1'000U, 4U,
+                  [&](usize i) { queue.push(static_cast<int>(i)); });
+      queue.close();
+    }
+    REQUIRE(sum == 999 * 1'000 / 2);
+  }
+}
+
+TEST_CASE("BufferPool bounds the buffers in use", "") {
+  auto pool = BufferPool{2U, 16U};
+  REQUIRE(pool.count() == 2U);
+  REQUIRE(pool.bufferSize() == 16U);
+
+  auto first  = pool.acquire();
+  auto second = pool.acquire();
+  REQUIRE(first.size() == 16U);
+  REQUIRE(first.data() != second.data());
+
+  // The third acquisition waits until a buffer is released.
+  auto released       = atomic<bool>{false};
+  auto waitedForFirst = atomic<bool>{false};
+  auto waiter         = jthread{[&] {
+    const auto third = pool.acquire();
+    waitedForFirst   = released && third.data() == first.data();
+    pool.release(third);
+  }};
+  this_thread::sleep_for(chrono::milliseconds{20});
+  released = true;
+  pool.release(first);
+  waiter.join();
+  REQUIRE(waitedForFirst);
+  pool.release(second);
+}
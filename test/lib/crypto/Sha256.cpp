@@ -169,6 +169,38 @@ TEST_CASE("Hash single-linked list of characters", "") {
   REQUIRE(s.digest() == expectedHash);
 }
 
+TEST_CASE("Hash contiguous and non-contiguous input alternating", "") {
+  const auto message = string(1000U, 'q') + string(100U, 'r');
+  auto expected      = Sha256Sum{};
+  expected.process(message);
+
+  // Block boundaries fall into both kinds of input.
+  auto s          = Sha256Sum{};
+  const auto view = string_view{message};
+  s.process(view.substr(0U, 30U));
+  s.process(forward_list<char>(view.begin() + 30, view.begin() + 100));
+  s.process(view.substr(100U, 500U));
+  s.process(vector<char>(view.begin() + 600, view.begin() + 1000));
+  s.process(forward_list<char>(view.begin() + 1000, view.end()));
+  REQUIRE(s.digest() == expected.digest());
+}
+
+TEST_CASE("Hash a FIPS vector split at unaligned offsets", "") {
+  // One million times 'a', see the examples of FIPS PUB 180-4.
+  const auto message = string(1'000'000U, 'a');
+  const auto view    = string_view{message};
+  auto s             = Sha256Sum{};
+  usize offset       = 0U;
+  for (usize i = 0U; offset < message.size(); ++i) {
+    // Pieces start within blocks, end within blocks and span many blocks.
+    const usize piece = array<usize, 5>{1U, 63U, 65U, 130U, 4'099U}[i % 5U];
+    s.process(view.substr(offset, piece));
+    offset += piece;
+  }
+  REQUIRE(s.digest() ==
+          "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
 TEST_CASE("Hash istream-view", "") {
   auto iss = istringstream{"Stream Class Iterator hashing works"};
   auto s   = Sha256Sum{};
@@ -197,6 +229,87 @@ TEST_CASE("Hash istream iterator-interface", "") {
           "c04084102785173be85abc3cdd55478facd9833d5fe4062e706992da30ff852d");
 }
 
+static_assert(BinaryHashFunctor<Sha256Sum>);
+// Wider elements would be hashed with all of their bytes if contiguous, but
+// cut down to one byte otherwise.
+static_assert(CryptHashable<vector<u8>> && CryptHashable<list<char>>);
+static_assert(!CryptHashable<vector<u32>> && !CryptHashable<list<u32>>);
+static_assert(ByteSizedIterator<string::iterator>);
+static_assert(!ByteSizedIterator<vector<u32>::iterator>);
+
+TEST_CASE("Digest as bytes", "") {
+  auto s = Sha256Sum{};
+  s.process("abc"sv);
+  const auto bytes = s.digest_bytes();
+  REQUIRE(bytes.front() == byte{0xba});
+  REQUIRE(bytes.back() == byte{0xad});
+  REQUIRE(s.digest() ==
+          "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // The digest does not change by requesting it again.
+  REQUIRE(s.digest_bytes() == bytes);
+  REQUIRE_THROWS_AS(s.process("d"sv), runtime_error);
+
+  s.reset();
+  REQUIRE(s.digest_bytes() != bytes);
+}
+
+TEST_CASE("Hash in constant expressions", "") {
+  // Two blocks, the padding does not fit into the first one.
+  constexpr auto message =
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"sv;
+  constexpr auto digest = [](auto input) {
+    auto s = Sha256Sum{};
+    s.process(input);
+    return s.digest_bytes();
+  };
+  constexpr auto expected = digest(message);
+  static_assert(expected[0] == byte{0x24} && expected[31] == byte{0xc1});
+  static_assert([] {
+    auto s = Sha256Sum{};
+    s.process("abc"sv);
+    return s.digest();
+  }() == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // Non-contiguous input in constant expressions.
+  static_assert(digest(message | views::reverse) ==
+                digest(string_view{string(message.rbegin(), message.rend())}));
+
+  // The runtime implementations agree with the constant evaluation.
+  REQUIRE(digest(message) == expected);
+}
+
+TEST_CASE("Sha256 compression implementations", "") {
+  const auto implementations = sha256Implementations();
+  const auto &portable       = implementations.back();
+  REQUIRE(portable.required.empty());
+
+  // "abc" padded to one block, see FIPS PUB 180-4 example.
+  auto abc  = array<u8, 64>{0x61, 0x62, 0x63, 0x80};
+  abc[63]   = 24U;
+  auto data = vector<u8>(64U * 17U);
+  ranges::generate(data, [i = 0U]() mutable {
+    return static_cast<u8>((i++ * 131U) ^ 0x5AU);
+  });
+
+  for (const auto &implementation : implementations) {
+    if (!CpuFeatureSet::host().contains(implementation.required)) {
+      continue;
+    }
+    INFO(implementation.name);
+    auto state = array<u32, 8>{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                               0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    implementation.function(state, abc);
+    REQUIRE(state == array<u32, 8>{0xba7816bf, 0x8f01cfea, 0x414140de,
+                                   0x5dae2223, 0xb00361a3, 0x96177a9c,
+                                   0xb410ff61, 0xf20015ad});
+
+    // Multiple blocks in one call.
+    auto expected = state;
+    implementation.function(state, data);
+    portable.function(expected, data);
+    REQUIRE(state == expected);
+  }
+}
+
 TEST_CASE("Benchmark for Sha256", "[.]") {
   auto generateToHash = []() -> string {
     auto r           = string{};
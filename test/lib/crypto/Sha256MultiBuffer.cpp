@@ -0,0 +1,100 @@
+module;
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Crypto:TestSha256MultiBuffer;
+
+import std;
+import jt.Crypto;
+
+using namespace std;
+using namespace jt;
+using namespace jt::crypto;
+
+namespace {
+string sha256(string_view message) {
+  auto hasher = Sha256Sum{};
+  hasher.process(message);
+  return hasher.digest();
+}
+
+/// Messages of all lengths around the block boundaries and a few long ones,
+/// so that lanes finish at different times.
+vector<string> testMessages() {
+  auto messages = vector<string>{};
+  for (usize length = 0U; length < 200U; ++length) {
+    auto message = string(length, ' ');
+    for (usize i = 0U; i < length; ++i) {
+      message[i] = static_cast<char>('a' + (i * 7U + length) % 26U);
+    }
+    messages.push_back(move(message));
+  }
+  messages.emplace_back(10'000U, 'x');
+  messages.emplace_back(4'097U, 'y');
+  return messages;
+}
+} // namespace
+
+TEST_CASE("Sha256 batch of few messages", "") {
+  REQUIRE(sha256Batch({}).empty());
+
+  const auto messages = array<string_view, 2>{"", "Hello"};
+  const auto digests  = sha256Batch(messages);
+  REQUIRE(digests.size() == 2U);
+  REQUIRE(digests[0] ==
+          "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  REQUIRE(digests[1] ==
+          "185f8db32271fe25f561a6fc938b2e264306ec304eda518007d1764826381969");
+}
+
+TEST_CASE("Sha256 batch implementations", "") {
+  const auto messages = testMessages();
+  auto views          = vector<string_view>(messages.begin(), messages.end());
+  auto expected       = vector<string>{};
+  ranges::transform(views, back_inserter(expected), sha256);
+  REQUIRE(sha256Batch(views) == expected);
+
+  // Start with the long messages, while the other lanes are refilled.
+  ranges::reverse(views);
+  ranges::reverse(expected);
+  REQUIRE(sha256Batch(views) == expected);
+
+  const auto implementations = sha256BatchImplementations();
+  const auto &sequential     = implementations.back();
+  REQUIRE(sequential.required.empty());
+
+  auto expectedStates = vector<array<u32, 8>>(views.size());
+  sequential.function(views, expectedStates);
+  for (const auto &implementation : implementations) {
+    if (!CpuFeatureSet::host().contains(implementation.required)) {
+      continue;
+    }
+    INFO(implementation.name);
+    for (const usize count : {usize{1U}, usize{7U}, usize{17U}, views.size()}) {
+      auto states = vector<array<u32, 8>>(count);
+      implementation.function(span{views}.first(count), states);
+      REQUIRE(ranges::equal(states, span{expectedStates}.first(count)));
+    }
+  }
+}
+
+TEST_CASE("Benchmark for Sha256 batches", "[.]") {
+  const auto messages = vector<string>(4096U, string(1000U, 'a'));
+  const auto views    = vector<string_view>(messages.begin(), messages.end());
+  BENCHMARK("Hash 4096 messages of 1000 bytes one by one") {
+    return ranges::count_if(views, [](string_view message) {
+      return sha256(message).front() == '0';
+    });
+  };
+  for (const auto &implementation : sha256BatchImplementations()) {
+    if (CpuFeatureSet::host().contains(implementation.required)) {
+      BENCHMARK("Hash 4096 messages of 1000 bytes " +
+                string{implementation.name}) {
+        auto states = vector<array<u32, 8>>(views.size());
+        implementation.function(views, states);
+        return states[0][0];
+      };
+    }
+  }
+}
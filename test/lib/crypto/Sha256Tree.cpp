@@ -0,0 +1,89 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Crypto:TestSha256Tree;
+
+import std;
+import jt.Crypto;
+
+using namespace std;
+using namespace jt;
+using namespace jt::crypto;
+
+namespace {
+/// SHA-256 of @c prefix followed by the bytes of the hex digests @c parts.
+string hashOf(char prefix, initializer_list<string_view> parts,
+              bool partsAreHex = true) {
+  auto message = string{prefix};
+  for (const auto part : parts) {
+    if (!partsAreHex) {
+      message += part;
+      continue;
+    }
+    for (usize i = 0U; i < part.size(); i += 2U) {
+      u8 value = 0U;
+      from_chars(part.data() + i, part.data() + i + 2U, value, 16);
+      message += static_cast<char>(value);
+    }
+  }
+  auto hasher = Sha256Sum{};
+  hasher.process(message);
+  return hasher.digest();
+}
+} // namespace
+
+static_assert(BinaryHashFunctor<Sha256Tree>);
+
+TEST_CASE("Sha256Tree format", "") {
+  SECTION("Empty input") {
+    auto tree = Sha256Tree{4U};
+    REQUIRE(tree.digest() ==
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(tree.digest_bytes() == Sha256Sum{}.digest_bytes());
+  }
+  SECTION("Single chunk") {
+    auto tree = Sha256Tree{4U};
+    tree.process("abc"sv);
+    REQUIRE(tree.digest() == hashOf(0x00, {"abc"}, false));
+  }
+  SECTION("Unbalanced tree of three chunks") {
+    const auto leaf0 = hashOf(0x00, {"abcd"}, false);
+    const auto leaf1 = hashOf(0x00, {"efgh"}, false);
+    const auto leaf2 = hashOf(0x00, {"ij"}, false);
+    const auto left  = hashOf(0x01, {leaf0, leaf1});
+
+    auto tree = Sha256Tree{4U};
+    tree.process("abcdefghij"sv);
+    REQUIRE(tree.digest() == hashOf(0x01, {left, leaf2}));
+  }
+}
+
+TEST_CASE("Sha256Tree is independent of the input pieces and threads", "") {
+  auto message = string(10'000U, ' ');
+  for (usize i = 0U; i < message.size(); ++i) {
+    message[i] = static_cast<char>('a' + i * 31U % 26U);
+  }
+  auto whole  = Sha256Tree{64U, 1U};
+  auto larger = Sha256Tree{128U, 1U};
+  whole.process(message);
+  larger.process(message);
+  const auto expected = whole.digest();
+  // The digest depends on the chunk size.
+  REQUIRE(expected != larger.digest());
+
+  for (const usize threads : {1U, 3U, 8U}) {
+    for (const usize piece : {1U, 63U, 64U, 100U, 1'000U}) {
+      INFO(threads << " threads, pieces of " << piece);
+      auto tree = Sha256Tree{64U, threads};
+      for (usize offset = 0U; offset < message.size(); offset += piece) {
+        tree.process(string_view{message}.substr(offset, piece));
+      }
+      REQUIRE(tree.digest() == expected);
+      REQUIRE_THROWS_AS(tree.process("more"sv), runtime_error);
+      tree.reset();
+      tree.process(message);
+      REQUIRE(tree.digest() == expected);
+    }
+  }
+}
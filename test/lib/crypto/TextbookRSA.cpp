@@ -37,8 +37,7 @@ template <typename Int> string toHexString(const Int &n) {
 }
 } // namespace
 
-TEMPLATE_TEST_CASE("TextbookRSA Encrypt/Decrypt Inversion",
-                   "", /*math::BigUInt,*/
+TEMPLATE_TEST_CASE("TextbookRSA Encrypt/Decrypt Inversion", "", math::BigUInt,
                    math::NaturalN) {
   using namespace crypto;
 
@@ -17,6 +17,16 @@ static_assert(NaturalNumber<BigUInt>);
 static_assert(NaturalNumber<uint>);
 static_assert(!NaturalNumber<int>);
 
+namespace {
+/// Parse decimal @c digits, that do not fit into the built-in integers.
+BigUInt parse(const char *digits) {
+  auto result = BigUInt{};
+  auto stream = istringstream{digits};
+  stream >> result;
+  return result;
+}
+} // namespace
+
 TEST_CASE("BigUInt Construction", "") {
   SECTION("2^11") {
     BigUInt bu{u64{2048ULL}};
@@ -53,6 +63,12 @@ TEST_CASE("BigUInt ConversionToBuiltin", "") {
     const auto C = N.convertTo<usize>();
     REQUIRE(C == 12389614ULL);
   }
+
+  SECTION("u64 beyond 32 bits") {
+    const auto N = BigUInt{numeric_limits<u64>::max()};
+    REQUIRE(N.convertTo<u64>() == numeric_limits<u64>::max());
+    REQUIRE_THROWS_AS((N + 1U).convertTo<u64>(), out_of_range);
+  }
 }
 
 TEST_CASE("BigUInt Comparison", "") {
@@ -336,6 +352,17 @@ TEST_CASE("Multiplication", "") {
     a *= BigUInt{564123ULL};
     REQUIRE(a == BigUInt{1283912381092ULL * 564123ULL});
   }
+
+  SECTION("Multiple words") {
+    auto a = parse("340282366920938463463374607431768211455");
+    a *= parse("18446744073709551617");
+    const auto product =
+        parse("6277101735386680764176071790128604879547283307822093172735");
+    const auto difference =
+        parse("6277101735386680763835789423207666416083908700390324961280");
+    REQUIRE(a == product);
+    REQUIRE(a - parse("340282366920938463463374607431768211455") == difference);
+  }
 }
 
 TEST_CASE("Division", "") {
@@ -537,6 +564,20 @@ TEST_CASE("DivMod", "") {
     BigUInt b{1247U};
     REQUIRE(divmod(a, b) == pair{BigUInt{993U}, BigUInt{1139U}});
   }
+  SECTION("Divisor with the same number of digits as the dividend") {
+    REQUIRE(divmod(BigUInt{15U}, BigUInt{9U}) ==
+            pair{BigUInt{1U}, BigUInt{6U}});
+    REQUIRE(divmod(BigUInt{9U}, BigUInt{9U}) ==
+            pair{BigUInt{1U}, BigUInt{0U}});
+  }
+  SECTION("Numbers spanning multiple words") {
+    const auto a      = parse("1234567890123456789012345678901234567890");
+    const auto b      = parse("98765432109876543210");
+    const auto [q, r] = divmod(a, b);
+    REQUIRE(q == 12499999886093750001_N);
+    REQUIRE(r == parse("54205246805420524680"));
+    REQUIRE(q * b + r == a);
+  }
 }
 
 TEST_CASE("Printing", "") {
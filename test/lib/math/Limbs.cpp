@@ -0,0 +1,225 @@
+module;
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Math:TestLimbs;
+
+import std;
+import jt.Math;
+
+using namespace std;
+using namespace jt;
+using namespace jt::math;
+using namespace jt::math::limbs;
+
+namespace {
+constexpr limb maxLimb = numeric_limits<limb>::max();
+} // namespace
+
+TEST_CASE("Limbs addition and subtraction", "") {
+  SECTION("Carry through all limbs") {
+    auto a           = array<limb, 3>{maxLimb, maxLimb, 5U};
+    const auto b     = array<limb, 3>{1U, 0U, 0U};
+    const limb carry = add_n(a, a, b);
+    REQUIRE(carry == 0U);
+    REQUIRE(a == array<limb, 3>{0U, 0U, 6U});
+
+    auto c = array<limb, 2>{maxLimb, maxLimb};
+    REQUIRE(add_1(c, c, 1U) == 1U);
+    REQUIRE(c == array<limb, 2>{0U, 0U});
+    REQUIRE(add_1(c, c, 7U) == 0U);
+    REQUIRE(c == array<limb, 2>{7U, 0U});
+  }
+  SECTION("Borrow through all limbs") {
+    auto a           = array<limb, 3>{0U, 0U, 6U};
+    const auto b     = array<limb, 3>{1U, 0U, 0U};
+    auto r           = array<limb, 3>{};
+    const limb carry = sub_n(r, a, b);
+    REQUIRE(carry == 0U);
+    REQUIRE(r == array<limb, 3>{maxLimb, maxLimb, 5U});
+
+    REQUIRE(sub_n(r, b, a) == 1U);
+    REQUIRE(sub_1(a, a, 1U) == 0U);
+    REQUIRE(a == array<limb, 3>{maxLimb, maxLimb, 5U});
+
+    auto zero = array<limb, 2>{};
+    REQUIRE(sub_1(zero, zero, 1U) == 1U);
+    REQUIRE(zero == array<limb, 2>{maxLimb, maxLimb});
+  }
+  SECTION("Empty spans") {
+    REQUIRE(add_1(span<limb>{}, span<const limb>{}, 3U) == 3U);
+    REQUIRE(sub_1(span<limb>{}, span<const limb>{}, 3U) == 3U);
+    REQUIRE(cmp(span<const limb>{}, span<const limb>{}) ==
+            strong_ordering::equal);
+  }
+}
+
+TEST_CASE("Limbs comparison", "") {
+  const auto a = array<limb, 3>{5U, 0U, 1U};
+  const auto b = array<limb, 3>{0U, 1U, 1U};
+  REQUIRE(cmp(a, b) == strong_ordering::less);
+  REQUIRE(cmp(b, a) == strong_ordering::greater);
+  REQUIRE(cmp(a, a) == strong_ordering::equal);
+}
+
+TEST_CASE("Limbs multiplication", "") {
+  SECTION("addmul_1 with maximal limbs") {
+    auto r           = array<limb, 2>{maxLimb, maxLimb};
+    const auto a     = array<limb, 2>{maxLimb, maxLimb};
+    const limb carry = addmul_1(r, a, maxLimb);
+    // (2^128 - 1) * (2^64 - 1) + 2^128 - 1 == 2^192 - 2^64
+    REQUIRE(r == array<limb, 2>{0U, maxLimb});
+    REQUIRE(carry == maxLimb);
+  }
+  SECTION("Two limb products against 128 bit arithmetic") {
+    auto generator = mt19937_64{42U};
+    for (int i = 0; i < 1'000; ++i) {
+      const limb x = generator();
+      const limb y = generator();
+      auto r       = array<limb, 2>{};
+      mul(r, array<limb, 1>{x}, array<limb, 1>{y});
+      REQUIRE(r[0] == x * y);
+
+      // Compare the high limb with the sum of the partial products.
+      const limb xLow  = x & 0xFFFF'FFFFU;
+      const limb xHigh = x >> 32U;
+      const limb yLow  = y & 0xFFFF'FFFFU;
+      const limb yHigh = y >> 32U;
+      const limb cross = (xLow * yLow >> 32U) + (xHigh * yLow & 0xFFFF'FFFFU) +
+                         (xLow * yHigh & 0xFFFF'FFFFU);
+      const limb high = xHigh * yHigh + (xHigh * yLow >> 32U) +
+                        (xLow * yHigh >> 32U) + (cross >> 32U);
+      REQUIRE(r[1] == high);
+    }
+  }
+  SECTION("mul_1 and submul_1 are inverse") {
+    const auto a    = array<limb, 3>{maxLimb, 12345U, maxLimb};
+    auto r          = array<limb, 3>{};
+    const limb high = mul_1(r, a, maxLimb);
+
+    // Subtracting the same product again leaves zero and borrows the high limb.
+    REQUIRE(submul_1(r, a, maxLimb) == high);
+    REQUIRE(r == array<limb, 3>{});
+
+    // 0 - 3 * 2 == 2^128 - 6 with a borrow of 1.
+    auto zero = array<limb, 2>{};
+    REQUIRE(submul_1(zero, array<limb, 2>{3U, 0U}, 2U) == 1U);
+    REQUIRE(zero == array<limb, 2>{maxLimb - 5U, maxLimb});
+  }
+  SECTION("Multi limb product") {
+    // (2^192 - 1) * (2^128 - 1) == 2^320 - 2^192 - 2^128 + 1
+    const auto a = array<limb, 3>{maxLimb, maxLimb, maxLimb};
+    const auto b = array<limb, 2>{maxLimb, maxLimb};
+    auto r       = array<limb, 5>{};
+    mul(r, a, b);
+    REQUIRE(r == array<limb, 5>{1U, 0U, maxLimb, maxLimb - 1U, maxLimb});
+  }
+}
+
+TEST_CASE("Limbs addmul_1 implementations", "") {
+  const auto implementations = addmulImplementations();
+  const auto &portable       = implementations.back();
+  REQUIRE(portable.required.empty());
+
+  auto generator = mt19937_64{7U};
+  for (const auto &implementation : implementations) {
+    if (!CpuFeatureSet::host().contains(implementation.required)) {
+      continue;
+    }
+    INFO(implementation.name);
+    for (usize n = 0U; n < 40U; ++n) {
+      auto a = vector<limb>(n);
+      auto r = vector<limb>(n);
+      ranges::generate(a, ref(generator));
+      ranges::generate(r, ref(generator));
+      // Maximal limbs produce the longest carry chains.
+      if (n % 3U == 0U) {
+        ranges::fill(a, maxLimb);
+        ranges::fill(r, maxLimb);
+      }
+      const limb b = n % 3U == 0U ? maxLimb : generator();
+
+      auto expected          = r;
+      const limb carry       = portable.function(expected, a, b);
+      const limb actualCarry = implementation.function(r, a, b);
+      REQUIRE(actualCarry == carry);
+      REQUIRE(r == expected);
+    }
+  }
+}
+
+TEST_CASE("Limbs shifts", "") {
+  SECTION("Shift out of both ends") {
+    const auto a =
+        array<limb, 2>{0x8000'0000'0000'0001U, 0xF000'0000'0000'0000U};
+    auto r         = array<limb, 2>{};
+    const limb top = lshift(r, a, 4U);
+    REQUIRE(top == 0xFU);
+    REQUIRE(r == array<limb, 2>{0x10U, 0x8U});
+
+    const limb bottom = rshift(r, a, 4U);
+    REQUIRE(bottom == 0x1000'0000'0000'0000U);
+    REQUIRE(r == array<limb, 2>{0x0800'0000'0000'0000U,
+                                0x0F00'0000'0000'0000U});
+  }
+  SECTION("Overlapping by one limb") {
+    // Shifting by one limb and one bit in place in both directions.
+    auto digits     = array<limb, 4>{maxLimb, 1U, 0U, 0U};
+    const auto grow = span{digits};
+    digits[3]       = lshift(grow.subspan(1U, 2U), grow.first(2U), 1U);
+    digits[0]       = 0U;
+    REQUIRE(digits == array<limb, 4>{0U, maxLimb - 1U, 3U, 0U});
+
+    rshift(grow.first(3U), grow.subspan(1U), 1U);
+    REQUIRE(digits == array<limb, 4>{maxLimb, 1U, 0U, 0U});
+  }
+}
+
+TEST_CASE("NaturalNView", "") {
+  const auto digits = array<limb, 4>{7U, 0U, 1U, 0U};
+  const auto view   = NaturalNView{digits};
+  REQUIRE(view.size() == 3U);
+  REQUIRE(view.binaryDigits() == 2U * 64U + 1U);
+  REQUIRE_FALSE(view.isEven());
+  REQUIRE(NaturalNView{}.isZero());
+  REQUIRE(NaturalNView{span{digits}.subspan(1U, 1U)}.isZero());
+  REQUIRE(NaturalNView{span{digits}.first(1U)} < view);
+
+  SECTION("Conversion between number types") {
+    const auto n = NaturalN{view};
+    const auto b = BigUInt{n.view()};
+    REQUIRE(n.view() == view);
+    REQUIRE(b.view() == view);
+    REQUIRE(b.binaryDigits() == view.binaryDigits());
+    auto expected = BigUInt{1U};
+    expected <<= 128;
+    REQUIRE(b == expected + 7U);
+    REQUIRE(NaturalN{BigUInt{0U}.view()} == NaturalN{0U});
+  }
+}
+
+TEST_CASE("Benchmark for limb kernels", "[.]") {
+  auto generator = mt19937_64{1U};
+  auto a         = vector<limb>(32U);
+  auto b         = vector<limb>(32U);
+  ranges::generate(a, ref(generator));
+  ranges::generate(b, ref(generator));
+  auto r = vector<limb>(64U);
+
+  BENCHMARK("add_n 32 limbs") {
+    return add_n(span{r}.first(32U), a, b);
+  };
+  for (const auto &implementation : addmulImplementations()) {
+    if (CpuFeatureSet::host().contains(implementation.required)) {
+      BENCHMARK("addmul_1 32 limbs " + string{implementation.name}) {
+        return implementation.function(span{r}.first(32U), a, b[0]);
+      };
+    }
+  }
+  BENCHMARK("mul 32x32 limbs") {
+    mul(r, a, b);
+    return r[63];
+  };
+  BENCHMARK("lshift 32 limbs") { return lshift(span{r}.first(32U), a, 3U); };
+}
@@ -77,6 +77,31 @@ TEST_CASE("IsPrime", "") {
   }
 }
 
+TEST_CASE("Prime factors and primality with a PrimeTable", "") {
+  const auto primes = sievePrimeTable(0U, 1'000U);
+
+  SECTION("Agrees with trial division") {
+    for (u64 n = 0U; n < 5'000U; ++n) {
+      REQUIRE(getPrimeFactors(n, primes) == getPrimeFactors(n));
+      REQUIRE(isPrime(n, primes) == isPrime(n));
+    }
+  }
+  SECTION("Numbers beyond the square of the table") {
+    const auto n = BigUInt{1'000'003U} * BigUInt{1'000'033U};
+    REQUIRE(getPrimeFactors(n, primes) ==
+            vector<BigUInt>{BigUInt{1'000'003U}, BigUInt{1'000'033U}});
+    REQUIRE(!isPrime(n, primes));
+    REQUIRE(isPrime(u64{1'000'000'007U}, primes));
+  }
+  SECTION("Tables without known limit are not used") {
+    const auto partial = sievePrimeTable(100U, 200U);
+    REQUIRE(getPrimeFactors(u64{3U * 101U * 101U}, partial) ==
+            vector<u64>{3U, 101U, 101U});
+    REQUIRE(isPrime(u64{101U}, partial));
+    REQUIRE(!isPrime(u64{4U}, partial));
+  }
+}
+
 TEST_CASE("SieveEratosthenes", "") {
   const auto first1000 = sieveEratosthenes<BigUInt>(usize{1000U});
 
@@ -104,3 +129,65 @@ TEST_CASE("LCM", "") {
     REQUIRE(lcm(3'528_N, 3'780_N) == 52'920_N);
   }
 }
+
+TEST_CASE("SmallestPrimeFactorTable", "") {
+  const auto table = SmallestPrimeFactorTable{100'000U};
+  REQUIRE(table.limit() == 100'000U);
+
+  SECTION("Smallest prime factors") {
+    REQUIRE(table.smallestPrimeFactor(2U) == 2U);
+    REQUIRE(table.smallestPrimeFactor(91U) == 7U);
+    REQUIRE(table.smallestPrimeFactor(99'991U) == 99'991U);
+    REQUIRE(table.isPrime(99'991U));
+    REQUIRE(!table.isPrime(0U));
+    REQUIRE(!table.isPrime(1U));
+    REQUIRE(!table.isPrime(99'999U));
+  }
+  SECTION("Factorization") {
+    REQUIRE(table.factorize(0U).empty());
+    REQUIRE(table.factorize(1U).empty());
+    REQUIRE(table.factorize(13U) == vector<u32>{13U});
+    REQUIRE(table.factorize(84U) == vector<u32>{2U, 2U, 3U, 7U});
+    REQUIRE(table.factorize(65'536U) == vector<u32>(16U, 2U));
+    for (u32 n = 2U; n < 3'000U; ++n) {
+      auto factors = getPrimeFactors(n);
+      if (factors.empty()) {
+        factors.push_back(n);
+      }
+      REQUIRE(table.factorize(n) == factors);
+    }
+  }
+  SECTION("Totient and divisor count") {
+    const auto totients = totientTable(table.limit());
+    const auto divisors = divisorCountTable(table.limit());
+    REQUIRE(totients[0] == 0U);
+    REQUIRE(totients[1] == 1U);
+    REQUIRE(totients[36] == 12U);
+    REQUIRE(totients[97] == 96U);
+    REQUIRE(divisors[1] == 1U);
+    REQUIRE(divisors[36] == 9U);
+    REQUIRE(divisors[97] == 2U);
+    REQUIRE(divisors[65'536] == 17U);
+    for (u32 n = 0U; n < table.limit(); ++n) {
+      REQUIRE(table.totient(n) == totients[n]);
+      REQUIRE(table.divisorCount(n) == divisors[n]);
+    }
+  }
+  SECTION("Batch factorization") {
+    auto values = vector<u64>{};
+    for (u64 n = 0U; n < 20'000U; ++n) {
+      values.push_back((n * 7'919U) % table.limit());
+    }
+    for (const usize threads : {1U, 3U}) {
+      const auto batch = table.factorize(span<const u64>{values}, threads);
+      REQUIRE(batch.size() == values.size());
+      for (usize i = 0U; i < values.size(); ++i) {
+        REQUIRE(ranges::equal(batch[i],
+                              table.factorize(static_cast<u32>(values[i]))));
+      }
+    }
+    REQUIRE(table.factorize(span<const u32>{}).size() == 0U);
+    const auto tooBig = vector<u32>{12U, 100'000U};
+    REQUIRE_THROWS_AS(table.factorize(span<const u32>{tooBig}), out_of_range);
+  }
+}
@@ -0,0 +1,156 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Math:TestPrimeSieve;
+
+import std;
+import jt.Math;
+
+using namespace std;
+using namespace jt;
+using namespace jt::math;
+
+namespace {
+bool isPrimeByTrialDivision(u64 n) {
+  if (n < 2U) {
+    return false;
+  }
+  for (u64 d = 2U; d * d <= n; ++d) {
+    if (n % d == 0U) {
+      return false;
+    }
+  }
+  return true;
+}
+
+vector<u64> primesBetween(u64 low, u64 high) {
+  auto primes = vector<u64>{};
+  forEachPrime(low, high, [&primes](u64 p) { primes.push_back(p); });
+  return primes;
+}
+
+vector<u64> primesByTrialDivision(u64 low, u64 high) {
+  auto primes = vector<u64>{};
+  for (u64 n = low; n < high; ++n) {
+    if (isPrimeByTrialDivision(n)) {
+      primes.push_back(n);
+    }
+  }
+  return primes;
+}
+} // namespace
+
+TEST_CASE("Segmented Sieve small intervals", "") {
+  SECTION("Below 100") {
+    REQUIRE(primesBetween(0U, 100U) ==
+            vector<u64>{2,  3,  5,  7,  11, 13, 17, 19, 23, 29, 31, 37, 41,
+                        43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97});
+  }
+  SECTION("Empty intervals") {
+    REQUIRE(primesBetween(0U, 0U).empty());
+    REQUIRE(primesBetween(0U, 2U).empty());
+    REQUIRE(primesBetween(24U, 29U).empty());
+    REQUIRE(primesBetween(100U, 50U).empty());
+  }
+  SECTION("Bounds are half-open") {
+    REQUIRE(primesBetween(2U, 3U) == vector<u64>{2U});
+    REQUIRE(primesBetween(13U, 18U) == vector<u64>{13U, 17U});
+    REQUIRE(primesBetween(14U, 17U).empty());
+  }
+  SECTION("Every small interval matches trial division") {
+    for (u64 low = 0U; low < 300U; low += 7U) {
+      for (u64 high = low; high < 400U; high += 13U) {
+        REQUIRE(primesBetween(low, high) == primesByTrialDivision(low, high));
+      }
+    }
+  }
+}
+
+TEST_CASE("Segmented Sieve spanning multiple segments", "") {
+  SECTION("Prime counting function") {
+    usize count = 0U;
+    forEachPrime(0U, 1'000'000U, [&count](u64 /*p*/) { ++count; });
+    REQUIRE(count == 78'498U);
+  }
+  SECTION("Across a segment boundary") {
+    // Each segment covers 2^18 odd numbers.
+    const u64 boundary = u64{2U} << 18U;
+    REQUIRE(primesBetween(boundary - 500U, boundary + 500U) ==
+            primesByTrialDivision(boundary - 500U, boundary + 500U));
+  }
+  SECTION("Primes are ascending") {
+    const auto primes = primesBetween(3'000'000U, 4'000'000U);
+    REQUIRE(ranges::is_sorted(primes));
+    REQUIRE(ranges::adjacent_find(primes) == primes.end());
+  }
+}
+
+TEST_CASE("Segmented Sieve with large offsets", "") {
+  const u64 low = 1'000'000'000'000U;
+  REQUIRE(primesBetween(low, low + 200U) ==
+          primesByTrialDivision(low, low + 200U));
+}
+
+TEST_CASE("Sieving primes", "") {
+  const auto primes = sievingPrimes(1'000U);
+  REQUIRE(primes == vector<u32>{17U, 19U, 23U, 29U, 31U});
+
+  SegmentedSieve sieve{500U, 1'000U, primes};
+  auto count = usize{0U};
+  while (sieve.nextSegment()) {
+    sieve.forEachPrimeInSegment([&count](u64 /*p*/) { ++count; });
+  }
+  REQUIRE(count == 168U - 95U);
+}
+
+TEST_CASE("Parallel Sieve", "") {
+  SECTION("Matches the sequential sieve") {
+    const auto expected = primesBetween(0U, 3'000'000U);
+    for (const usize threads : {1U, 2U, 3U, 8U}) {
+      REQUIRE(sieveRange<u64>(0U, 3'000'000U, threads) == expected);
+    }
+  }
+  SECTION("Offset interval") {
+    const u64 low  = 10'000'000U;
+    const u64 high = 12'345'679U;
+    REQUIRE(sieveRange<u64>(low, high, 4U) == primesBetween(low, high));
+  }
+  SECTION("Tiny and empty intervals") {
+    REQUIRE(sieveRange<u32>(0U, 20U, 4U) ==
+            vector<u32>{2U, 3U, 5U, 7U, 11U, 13U, 17U, 19U});
+    REQUIRE(sieveRange<u32>(20U, 20U, 4U).empty());
+    REQUIRE(sieveRange<u32>(20U, 10U, 4U).empty());
+  }
+  SECTION("Arbitrary NaturalNumber types") {
+    const auto primes = sieveRange<BigUInt>(990U, 1'000U, 2U);
+    REQUIRE(primes == vector<BigUInt>{BigUInt{991U}, BigUInt{997U}});
+  }
+}
+
+TEST_CASE("Lazy Prime Range", "") {
+  static_assert(ranges::input_range<PrimeRange>);
+  static_assert(ranges::view<PrimeRange>);
+
+  SECTION("Matches the eager sieve") {
+    auto lazy = vector<u64>{};
+    for (const u64 prime : primes(0U, 1'000'000U)) {
+      lazy.push_back(prime);
+    }
+    REQUIRE(lazy == primesBetween(0U, 1'000'000U));
+  }
+  SECTION("Empty interval") {
+    auto range = primes(24U, 29U);
+    REQUIRE(range.begin() == range.end());
+  }
+  SECTION("Only the consumed primes are computed") {
+    auto firstPrimes = vector<u64>{};
+    for (const u64 prime :
+         primes(1'000'000'000'000U, 2'000'000'000'000U) | views::take(3)) {
+      firstPrimes.push_back(prime);
+    }
+    REQUIRE(firstPrimes == vector<u64>{1'000'000'000'039U,
+                                       1'000'000'000'061U,
+                                       1'000'000'000'063U});
+  }
+}
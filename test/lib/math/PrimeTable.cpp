@@ -0,0 +1,179 @@
+module;
+
+#include <catch2/catch_test_macros.hpp>
+
+module jt.Math:TestPrimeTable;
+
+import std;
+import jt.Math;
+
+using namespace std;
+using namespace jt;
+using namespace jt::math;
+
+namespace {
+/// Return a path in the temporary directory, that no concurrent test run
+/// uses.
+filesystem::path uniqueTemporaryPath(string_view name) {
+  auto device = random_device{};
+  return filesystem::temp_directory_path() /
+         (string{name} + "-" + to_string(device()));
+}
+
+/// Overwrite the bytes of the file at @c path from @c offset on.
+template <typename T>
+void overwrite(const filesystem::path &path, usize offset, const T &value) {
+  auto out = fstream{path, ios::binary | ios::in | ios::out};
+  out.seekp(static_cast<streamoff>(offset));
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/// Return the message of the error, that loading @c path throws.
+string loadError(const filesystem::path &path) {
+  try {
+    [[maybe_unused]] const auto table = PrimeTable::load(path);
+  } catch (const runtime_error &e) {
+    return e.what();
+  }
+  return "";
+}
+} // namespace
+
+TEST_CASE("PrimeTable Construction", "") {
+  SECTION("Default Construction") {
+    PrimeTable t;
+    REQUIRE(t.empty());
+    REQUIRE(t.size() == 0U);
+    REQUIRE(t.begin() == t.end());
+    REQUIRE_THROWS_AS(t.at(0U), out_of_range);
+  }
+
+  SECTION("Appending primes") {
+    PrimeTable t;
+    for (const u64 p : {2U, 3U, 5U, 7U, 11U}) {
+      t.push_back(p);
+    }
+    REQUIRE(t.size() == 5U);
+    REQUIRE(t.front() == 2U);
+    REQUIRE(t.back() == 11U);
+    REQUIRE(t[3] == 7U);
+    REQUIRE(t.at(4) == 11U);
+    REQUIRE_THROWS_AS(t.at(5), out_of_range);
+  }
+}
+
+TEST_CASE("PrimeTable from the sieve", "") {
+  const auto expected = sieveRange<u64>(0U, 2'000'000U, 1U);
+  const auto table    = sievePrimeTable(0U, 2'000'000U);
+  REQUIRE(table.size() == expected.size());
+
+  SECTION("Iteration") {
+    REQUIRE(ranges::equal(table, expected));
+  }
+  SECTION("Random Access") {
+    for (usize i = 0U; i < expected.size(); i += 997U) {
+      REQUIRE(table[i] == expected[i]);
+    }
+    REQUIRE(table[expected.size() - 1U] == expected.back());
+  }
+  SECTION("Membership") {
+    REQUIRE(table.contains(2U));
+    REQUIRE(table.contains(1'999'993U));
+    REQUIRE(!table.contains(0U));
+    REQUIRE(!table.contains(1U));
+    REQUIRE(!table.contains(1'999'995U));
+    REQUIRE(!table.contains(2'000'003U));
+  }
+  SECTION("Compact storage") {
+    // The gaps take a single byte and the index one sixty-fourth of a sample.
+    REQUIRE(table.byteSize() < table.size() * 5U / 4U);
+  }
+  SECTION("Multi-threaded sieving") {
+    REQUIRE(ranges::equal(sievePrimeTable(0U, 2'000'000U, 4U), expected));
+  }
+}
+
+TEST_CASE("PrimeTable with large gaps", "") {
+  // The gaps are not required to be small, they are encoded with multiple
+  // bytes if necessary.
+  const auto values =
+      vector<u64>{1'000'003U, 1'000'033U, 5'000'011U, 5'000'077U,
+                  u64{1U} << 40U, (u64{1U} << 40U) + 15U};
+  PrimeTable t;
+  for (const u64 v : values) {
+    t.push_back(v);
+  }
+  REQUIRE(ranges::equal(t, values));
+  REQUIRE(t[4] == u64{1U} << 40U);
+  REQUIRE(t.contains(5'000'077U));
+  REQUIRE(!t.contains(5'000'078U));
+}
+
+TEST_CASE("PrimeTable limit and extension", "") {
+  auto table = sievePrimeTable(0U, 1'000U);
+  REQUIRE(table.limit() == 1'000U);
+  REQUIRE(table.size() == 168U);
+
+  table.extend(500U);
+  REQUIRE(table.size() == 168U);
+
+  table.extend(1'000'000U);
+  REQUIRE(table.limit() == 1'000'000U);
+  REQUIRE(ranges::equal(table, sieveRange<u64>(0U, 1'000'000U, 1U)));
+
+  REQUIRE(sievePrimeTable(100U, 200U).limit() == 0U);
+  REQUIRE(sievingPrimes(table, 1'000U) == sievingPrimes(1'000U));
+  REQUIRE(sievingPrimes(table, u64{1U} << 50U) ==
+          sievingPrimes(u64{1U} << 50U));
+}
+
+TEST_CASE("PrimeTable persistence", "") {
+  const auto path     = uniqueTemporaryPath("jt-computing-prime-table");
+  const auto original = sievePrimeTable(0U, 1'000'000U);
+  original.save(path);
+
+  SECTION("Roundtrip") {
+    const auto loaded = PrimeTable::load(path);
+    REQUIRE(loaded.size() == original.size());
+    REQUIRE(loaded.limit() == original.limit());
+    REQUIRE(loaded.back() == original.back());
+    REQUIRE(loaded.byteSize() == original.byteSize());
+    REQUIRE(ranges::equal(loaded, original));
+    REQUIRE(loaded[12'345U] == original[12'345U]);
+    REQUIRE(loaded.contains(999'983U));
+  }
+  SECTION("Extending a loaded table and saving it in place") {
+    auto loaded = PrimeTable::load(path);
+    loaded.extend(2'000'000U);
+    loaded.save(path);
+
+    const auto reloaded = PrimeTable::load(path);
+    REQUIRE(reloaded.limit() == 2'000'000U);
+    REQUIRE(ranges::equal(reloaded, sieveRange<u64>(0U, 2'000'000U, 1U)));
+  }
+  SECTION("Invalid files are rejected") {
+    // The header starts with 8 bytes of magic, followed by the version and
+    // the byte order mark with 4 bytes each.
+    overwrite(path, 0U, array<char, 8>{'N', 'O', 'T', 'P', 'R', 'I', 'M', 'E'});
+    REQUIRE(loadError(path).ends_with("is not a prime table"));
+
+    original.save(path);
+    overwrite(path, 8U, u32{2U});
+    REQUIRE(loadError(path).ends_with("has an unsupported version"));
+
+    original.save(path);
+    overwrite(path, 12U, u32{0x04030201U});
+    REQUIRE(
+        loadError(path).ends_with("was written on an incompatible platform"));
+
+    filesystem::resize_file(path, 4U);
+    REQUIRE(loadError(path).ends_with("is not a prime table"));
+  }
+  SECTION("Truncated files are rejected") {
+    filesystem::resize_file(path, filesystem::file_size(path) - 1U);
+    REQUIRE_THROWS_AS(PrimeTable::load(path), runtime_error);
+  }
+
+  filesystem::remove(path);
+  REQUIRE_THROWS_AS(PrimeTable::load(path), system_error);
+}